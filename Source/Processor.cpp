@@ -9,6 +9,401 @@
 
 namespace audio
 {
+    bool HQConfig::operator==(const HQConfig& other) const noexcept
+    {
+        return order == other.order && mode == other.mode && quality == other.quality;
+    }
+
+    bool HQConfig::operator!=(const HQConfig& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+    template<typename Float>
+    HQLane<Float>::HQLane(Params& params) :
+        pluginProcessor(params)
+#if PPDHasHQ
+        , oversampler()
+#endif
+    {
+    }
+
+    template<typename Float>
+    void HQLane<Float>::prepare(double sampleRate, const HQConfig& config)
+    {
+#if PPDHasHQ
+        oversampler.prepare(sampleRate, config.order, config.mode, config.quality);
+        pluginProcessor.prepare(oversampler.sampleRateUp);
+#else
+        juce::ignoreUnused(config);
+        pluginProcessor.prepare(sampleRate);
+#endif
+    }
+
+    template<typename Float>
+    void HQLane<Float>::operator()(Float* const* samples, MidiBuffer& midi,
+        int numChannels, int numSamples) noexcept
+    {
+#if PPDHasHQ
+        if (oversampler.canFuse() && pluginProcessor.canFuse())
+        {
+            // up- and downsampling happen sample by sample in here
+            PPDTraceScope("PluginProcessor (fused)");
+            pluginProcessor(oversampler, samples, midi, numChannels, numSamples);
+        }
+        else
+        {
+            typename dsp::Oversampler<Float>::BufferInfo bufferInfo;
+            {
+                PPDTraceScope("upsample");
+                bufferInfo = oversampler.upsample(samples, numChannels, numSamples);
+            }
+            {
+                PPDTraceScope("PluginProcessor");
+                const auto numSamplesUp = bufferInfo.numSamples;
+                Float* samplesUp[] = { bufferInfo.smplsL, bufferInfo.smplsR };
+                pluginProcessor(samplesUp, midi, numChannels, numSamplesUp);
+            }
+            PPDTraceScope("downsample");
+            oversampler.downsample(samples, numSamples);
+        }
+#else
+        PPDTraceScope("PluginProcessor");
+        pluginProcessor(samples, midi, numChannels, numSamples);
+#endif
+    }
+
+    template struct HQLane<float>;
+    template struct HQLane<double>;
+
+    template<typename Float>
+    HQSlot<Float>::HQSlot(Params& _params) :
+        params(_params),
+        lanes(),
+        midiEmpty(),
+        config{ dsp::OversamplingOrder::x1, dsp::OversamplerMode::Polyphase, dsp::OversamplerQuality::Balanced },
+        sampleRateUp(1.),
+        blockSizeUp(dsp::BlockSize)
+    {
+        // there is always a lane, so that patches can be loaded before prepare
+        lanes.push_back(std::make_unique<HQLane<Float>>(params));
+    }
+
+    template<typename Float>
+    void HQSlot<Float>::prepare(double sampleRate, int numChannels, const HQConfig& _config)
+    {
+        config = _config;
+        const auto numLanes = static_cast<size_t>((numChannels + 1) / 2);
+        while (lanes.size() < numLanes)
+            lanes.push_back(std::make_unique<HQLane<Float>>(params));
+        lanes.resize(numLanes);
+        for (auto& lane : lanes)
+            lane->prepare(sampleRate, config);
+
+#if PPDHasHQ
+        const auto& oversampler = lanes.front()->oversampler;
+        sampleRateUp = oversampler.sampleRateUp;
+        blockSizeUp = dsp::BlockSize * oversampler.getFactor();
+#else
+        sampleRateUp = sampleRate;
+        blockSizeUp = dsp::BlockSize;
+#endif
+    }
+
+    template<typename Float>
+    void HQSlot<Float>::release()
+    {
+        lanes.clear();
+        lanes.push_back(std::make_unique<HQLane<Float>>(params));
+        sampleRateUp = 1.;
+        blockSizeUp = dsp::BlockSize;
+    }
+
+    template<typename Float>
+    void HQSlot<Float>::operator()(Float* const* samples, MidiBuffer& midi,
+        int numChannels, int numSamples) noexcept
+    {
+        const auto numLanes = std::min((numChannels + 1) / 2, static_cast<int>(lanes.size()));
+        for (auto l = 0; l < numLanes; ++l)
+        {
+            const auto ch = l * 2;
+            const auto numChannelsLane = std::min(numChannels - ch, 2);
+            Float* samplesLane[] = { samples[ch], samples[ch + numChannelsLane - 1] };
+            (*lanes[l])(samplesLane, l == 0 ? midi : midiEmpty, numChannelsLane, numSamples);
+        }
+    }
+
+    template<typename Float>
+    void HQSlot<Float>::processBypassed(Float* const* samples, MidiBuffer& midi,
+        int numChannels, int numSamples) noexcept
+    {
+        const auto numLanes = std::min((numChannels + 1) / 2, static_cast<int>(lanes.size()));
+        for (auto l = 0; l < numLanes; ++l)
+        {
+            const auto ch = l * 2;
+            const auto numChannelsLane = std::min(numChannels - ch, 2);
+            Float* samplesLane[] = { samples[ch], samples[ch + numChannelsLane - 1] };
+            lanes[l]->pluginProcessor.processBlockBypassed(samplesLane, l == 0 ? midi : midiEmpty,
+                numChannelsLane, numSamples);
+        }
+    }
+
+    template<typename Float>
+    void HQSlot<Float>::copyState(const HQSlot& other) noexcept
+    {
+        const auto numLanes = std::min(lanes.size(), other.lanes.size());
+        for (size_t l = 0; l < numLanes; ++l)
+            lanes[l]->pluginProcessor.copyState(other.lanes[l]->pluginProcessor);
+    }
+
+    template<typename Float>
+    int HQSlot<Float>::getLatency() const noexcept
+    {
+#if PPDHasHQ
+        return lanes.front()->oversampler.getLatency();
+#else
+        return 0;
+#endif
+    }
+
+    template<typename Float>
+    int HQSlot<Float>::getFactor() const noexcept
+    {
+#if PPDHasHQ
+        return lanes.front()->oversampler.getFactor();
+#else
+        return 1;
+#endif
+    }
+
+    template struct HQSlot<float>;
+    template struct HQSlot<double>;
+
+    template<typename Float>
+    ProcessorChain<Float>::ProcessorChain(Params& params
+#if PPDHasTuningEditor
+        , XenManager&
+#endif
+    ) :
+        slots{ HQSlot<Float>(params), HQSlot<Float>(params) },
+        mixProcessor(),
+        latency(0),
+        buffer(),
+        sampleRate(1.),
+        numChannels(2),
+        activeIdx(0),
+        switchPending(false),
+        switchState(Switch::Idle),
+        switchIdx(0),
+        numWarmUp(0),
+        numFade(1)
+    {
+    }
+
+    template<typename Float>
+    void ProcessorChain<Float>::prepare(double _sampleRate, int _numChannels, const HQConfig& config)
+    {
+        sampleRate = _sampleRate;
+        numChannels = _numChannels;
+        activeIdx.store(0);
+        switchPending.store(false);
+        switchState = Switch::Idle;
+        numFade = std::max(1, static_cast<int>(std::round(sampleRate * FadeLengthMs * .001)));
+
+        auto& slot = slots[0];
+        slot.prepare(sampleRate, numChannels, config);
+        latency.store(slot.getLatency());
+        mixProcessor.prepare(sampleRate);
+    }
+
+    template<typename Float>
+    void ProcessorChain<Float>::release()
+    {
+        activeIdx.store(0);
+        switchPending.store(false);
+        switchState = Switch::Idle;
+        for (auto& slot : slots)
+            slot.release();
+        latency.store(0);
+    }
+
+    template<typename Float>
+    bool ProcessorChain<Float>::requestSwitch(const HQConfig& config)
+    {
+        if (switchPending.load(std::memory_order_acquire))
+            return false;
+        // the audio thread doesn't touch the spare slot until switchPending is set
+        const auto spareIdx = 1 - activeIdx.load(std::memory_order_acquire);
+        slots[spareIdx].prepare(sampleRate, numChannels, config);
+        switchPending.store(true, std::memory_order_release);
+        return true;
+    }
+
+    template<typename Float>
+    HQConfig ProcessorChain<Float>::getTargetConfig() const noexcept
+    {
+        const auto idx = activeIdx.load(std::memory_order_acquire);
+        if (switchPending.load(std::memory_order_acquire))
+            return slots[1 - idx].config;
+        return slots[idx].config;
+    }
+
+    template<typename Float>
+    void ProcessorChain<Float>::processOversampled(Float* const* samples, MidiBuffer& midi,
+        int numChannels, int numSamples) noexcept
+    {
+        const auto idx = activeIdx.load(std::memory_order_relaxed);
+        auto& active = slots[idx];
+
+        if (switchState == Switch::Idle && switchPending.load(std::memory_order_acquire))
+        {
+            // the spare slot's filters fill up before it can be heard,
+            // the slew limiter carries on from where the active one is
+            auto& spare = slots[1 - idx];
+            spare.copyState(active);
+            numWarmUp = spare.getLatency() * 2 + dsp::BlockSize;
+            switchState = Switch::WarmUp;
+            switchIdx = 0;
+        }
+
+        if (switchState == Switch::Idle)
+            return active(samples, midi, numChannels, numSamples);
+
+        if (switchState == Switch::FadeIn)
+        {
+            // the old slot is silent and out of the way already
+            active(samples, midi, numChannels, numSamples);
+            for (auto s = 0; s < numSamples; ++s, ++switchIdx)
+            {
+                const auto fade = getFade();
+                for (auto ch = 0; ch < numChannels; ++ch)
+                    samples[ch][s] *= fade;
+            }
+            if (switchIdx >= numFade)
+            {
+                switchState = Switch::Idle;
+                switchPending.store(false, std::memory_order_release);
+            }
+            return;
+        }
+
+        auto& spare = slots[1 - idx];
+        Float* samplesSpare[dsp::MaxChannels];
+        for (auto ch = 0; ch < numChannels; ++ch)
+        {
+            samplesSpare[ch] = buffer[ch].data();
+            SIMD::copy(samplesSpare[ch], samples[ch], numSamples);
+        }
+
+        active(samples, midi, numChannels, numSamples);
+        spare(samplesSpare, midi, numChannels, numSamples);
+
+        auto tookOver = false;
+        for (auto s = 0; s < numSamples; ++s, ++switchIdx)
+        {
+            if (switchState == Switch::WarmUp)
+            {
+                if (switchIdx < numWarmUp)
+                    continue;
+                switchState = spare.getLatency() == active.getLatency() ? Switch::Fade : Switch::FadeOut;
+                switchIdx = 0;
+            }
+            if (switchState == Switch::FadeOut && switchIdx >= numFade)
+            {
+                switchState = Switch::FadeIn;
+                switchIdx = 0;
+                tookOver = true;
+            }
+
+            const auto fade = getFade();
+            for (auto ch = 0; ch < numChannels; ++ch)
+            {
+                auto& y = samples[ch][s];
+                const auto ySpare = samplesSpare[ch][s];
+                switch (switchState)
+                {
+                // both slots are aligned, so their gains add up to 1
+                case Switch::Fade: y += fade * (ySpare - y); break;
+                case Switch::FadeOut: y -= fade * y; break;
+                default: y = fade * ySpare; break;
+                }
+            }
+        }
+
+        if (switchState == Switch::Fade && switchIdx >= numFade)
+        {
+            switchState = Switch::Idle;
+            activeIdx.store(1 - idx, std::memory_order_release);
+            switchPending.store(false, std::memory_order_release);
+        }
+        else if (tookOver)
+        {
+            // switchPending keeps the message thread off the old slot until the fade in is done
+            latency.store(spare.getLatency(), std::memory_order_relaxed);
+            activeIdx.store(1 - idx, std::memory_order_release);
+            if (switchIdx >= numFade)
+            {
+                switchState = Switch::Idle;
+                switchPending.store(false, std::memory_order_release);
+            }
+        }
+    }
+
+    template<typename Float>
+    void ProcessorChain<Float>::completeSwitch() noexcept
+    {
+        if (!switchPending.load(std::memory_order_acquire))
+            return;
+        const auto idx = activeIdx.load(std::memory_order_relaxed);
+        // after the fade out the spare slot is the active one already
+        if (switchState != Switch::FadeIn)
+        {
+            auto& spare = slots[1 - idx];
+            if (switchState == Switch::Idle)
+                spare.copyState(slots[idx]);
+            latency.store(spare.getLatency(), std::memory_order_relaxed);
+            activeIdx.store(1 - idx, std::memory_order_release);
+        }
+        switchState = Switch::Idle;
+        switchIdx = 0;
+        switchPending.store(false, std::memory_order_release);
+    }
+
+    template<typename Float>
+    Float ProcessorChain<Float>::getFade() const noexcept
+    {
+        if (switchIdx >= numFade)
+            return static_cast<Float>(1);
+        return static_cast<Float>(switchIdx) / static_cast<Float>(numFade);
+    }
+
+    template<typename Float>
+    HQSlot<Float>& ProcessorChain<Float>::getActiveSlot() noexcept
+    {
+        return slots[activeIdx.load(std::memory_order_acquire)];
+    }
+
+    template<typename Float>
+    const HQSlot<Float>& ProcessorChain<Float>::getActiveSlot() const noexcept
+    {
+        return slots[activeIdx.load(std::memory_order_acquire)];
+    }
+
+    template<typename Float>
+    bool ProcessorChain<Float>::isSwitching() const noexcept
+    {
+        return switchState != Switch::Idle;
+    }
+
+    template<typename Float>
+    bool ProcessorChain<Float>::isSwitchPending() const noexcept
+    {
+        return switchPending.load(std::memory_order_acquire);
+    }
+
+    template struct ProcessorChain<float>;
+    template struct ProcessorChain<double>;
+
     Processor::BusesProps Processor::makeBusesProps()
     {
         BusesProps bp;
@@ -36,22 +431,33 @@ namespace audio
 #endif
         state(),
         
-        pluginProcessor
+        chainF
         (
             params
 #if PPDHasTuningEditor
 		    ,xenManager
 #endif
         ),
-        audioBufferD(),
-
-        mixProcessor(),
-#if PPDHasHQ
-        oversampler(),
+        chainD
+        (
+            params
+#if PPDHasTuningEditor
+		    ,xenManager
 #endif
+        ),
         sampleRateUp(0.),
-        blockSizeUp(dsp::BlockSize)
+        blockSizeUp(dsp::BlockSize),
+        telemetry(),
+        telemetrySnapshot(),
+        telemetryPublisher()
     {
+        if (state.props.getUserSettings()->getBoolValue("publishTelemetry", false))
+            telemetryPublisher.open();
+#if PPDHasTracing
+        const auto pid = juce::String(juce::Process::getProcessID());
+        arch::trace::start(juce::File::getSpecialLocation(juce::File::tempDirectory)
+            .getChildFile("SlewOverTrace." + pid + ".json"));
+#endif
     }
 
     Processor::~Processor()
@@ -59,6 +465,9 @@ namespace audio
         auto& user = *state.props.getUserSettings();
         user.setValue("firstTimeUwU", false);
         user.save();
+#if PPDHasTracing
+        arch::trace::stop();
+#endif
     }
 
     bool Processor::supportsDoublePrecisionProcessing() const
@@ -134,25 +543,24 @@ namespace audio
     {
     }
 
-    void Processor::prepareToPlay(double sampleRate, int maxBlockSize)
+    void Processor::prepareToPlay(double sampleRate, int)
     {
-        auto latency = 0;
-
-        audioBufferD.setSize(2, maxBlockSize, false, true, false);
-		pluginProcessor.prepare(sampleRate);
-        mixProcessor.prepare(sampleRate);
+        const auto config = getHQConfig();
+        const auto numChannels = juce::jlimit(1, dsp::MaxChannels, getMainBusNumOutputChannels());
+        // the host only ever runs one precision between two prepareToPlays
+        if (isUsingDoublePrecision())
+        {
+            chainD.prepare(sampleRate, numChannels, config);
+            chainF.release();
+        }
+        else
+        {
+            chainF.prepare(sampleRate, numChannels, config);
+            chainD.release();
+        }
+        telemetry.prepare(sampleRate);
 
-#if PPDHasHQ
-        const auto hqEnabled = params(PID::HQ).getValue() > .5f;
-        oversampler.prepare(sampleRate, hqEnabled);
-        latency += oversampler.getLatency();
-        sampleRateUp = oversampler.sampleRateUp;
-        blockSizeUp = oversampler.enabled ? dsp::BlockSize2x : dsp::BlockSize;
-#else
-        sampleRateUp = sampleRate;
-		blockSizeUp = dsp::BlockSize;
-#endif
-        setLatencySamples(latency);
+        updateLatency();
         startTimerHz(4);
     }
 
@@ -166,21 +574,21 @@ namespace audio
         juce::ignoreUnused(layouts);
         return true;
 #endif
-        const auto mono = ChannelSet::mono();
-        const auto stereo = ChannelSet::stereo();
-
         const auto mainIn = layouts.getMainInputChannelSet();
         const auto mainOut = layouts.getMainOutputChannelSet();
 
         if (mainIn != mainOut)
             return false;
 
-        if (mainOut != stereo && mainOut != mono)
+        // any layout from mono up to 16 channels (7.1.4, 9.1.6 etc.)
+        if (mainOut.isDisabled() || mainOut.size() > dsp::MaxChannels)
             return false;
 
 #if PPDHasSidechain
         if (wrapperType != wrapperType_Standalone)
         {
+            const auto mono = ChannelSet::mono();
+            const auto stereo = ChannelSet::stereo();
             const auto scIn = layouts.getChannelSet(true, 1);
             if (!scIn.isDisabled())
                 if (scIn != mono && scIn != stereo)
@@ -198,7 +606,12 @@ namespace audio
 
     void Processor::getStateInformation(juce::MemoryBlock& destData)
     {
-        pluginProcessor.savePatch();
+        for (auto& slot : chainF.slots)
+            for (auto& lane : slot.lanes)
+                lane->pluginProcessor.savePatch();
+        for (auto& slot : chainD.slots)
+            for (auto& lane : slot.lanes)
+                lane->pluginProcessor.savePatch();
         params.savePatch(state);
         state.savePatch(*this, destData);
     }
@@ -207,12 +620,40 @@ namespace audio
     {
         state.loadPatch(*this, data, sizeInBytes);
         params.loadPatch(state);
-        pluginProcessor.loadPatch();
+        for (auto& slot : chainF.slots)
+            for (auto& lane : slot.lanes)
+                lane->pluginProcessor.loadPatch();
+        for (auto& slot : chainD.slots)
+            for (auto& lane : slot.lanes)
+                lane->pluginProcessor.loadPatch();
     }
 
     void Processor::processBlockBypassed(AudioBufferD& buffer, MidiBuffer& midiMessages)
+    {
+        processBlockChainBypassed(chainD, buffer, midiMessages);
+    }
+
+    void Processor::processBlockBypassed(AudioBufferF& buffer, MidiBuffer& midiMessages)
+    {
+        processBlockChainBypassed(chainF, buffer, midiMessages);
+    }
+
+    void Processor::processBlock(AudioBufferD& buffer, MidiBuffer& midiMessages)
+    {
+        processBlockChain(chainD, buffer, midiMessages);
+    }
+
+    void Processor::processBlock(AudioBufferF& buffer, MidiBuffer& midiMessages)
+    {
+        processBlockChain(chainF, buffer, midiMessages);
+    }
+
+    template<typename Float>
+    void Processor::processBlockChainBypassed(ProcessorChain<Float>& chain,
+        juce::AudioBuffer<Float>& buffer, MidiBuffer& midiMessages) noexcept
     {
         juce::ScopedNoDenormals noDenormals;
+        arch::ScopedRealtimeGuard realtimeGuard;
 		
         param::processMacroMod(params);
 		
@@ -220,53 +661,30 @@ namespace audio
         if (numSamplesMain == 0)
             return;
 		
-        const auto numChannels = buffer.getNumChannels() == 2 ? 2 : 1;
+        const auto numChannels = std::min(buffer.getNumChannels(), dsp::MaxChannels);
         auto samplesMain = buffer.getArrayOfWritePointers();
 
+        chain.completeSwitch();
         for (auto s = 0; s < numSamplesMain; s += dsp::BlockSize)
         {
-            double* samples[] = { &samplesMain[0][s], &samplesMain[1][s] };
+            Float* samples[dsp::MaxChannels];
+            for (auto ch = 0; ch < numChannels; ++ch)
+                samples[ch] = &samplesMain[ch][s];
             const auto dif = numSamplesMain - s;
             const auto numSamples = dif < dsp::BlockSize ? dif : dsp::BlockSize;
 
-            pluginProcessor.processBlockBypassed(samples, midiMessages, numChannels, numSamples);
-        }
-    }
-
-    void Processor::processBlockBypassed(AudioBufferF& buffer, MidiBuffer& midiMessages)
-    {
-        const auto numChannels = buffer.getNumChannels();
-        const auto numSamples = buffer.getNumSamples();
-
-        audioBufferD.setSize(numChannels, numSamples, true, false, true);
-
-        auto samplesF = buffer.getArrayOfWritePointers();
-        auto samplesD = audioBufferD.getArrayOfWritePointers();
-
-        for (auto ch = 0; ch < numChannels; ++ch)
-        {
-            const auto smplsF = samplesF[ch];
-            auto smplsD = samplesD[ch];
-
-            for (auto s = 0; s < numSamples; ++s)
-                smplsD[s] = static_cast<double>(smplsF[s]);
-        }
-
-        processBlockBypassed(audioBufferD, midiMessages);
-
-        for (auto ch = 0; ch < numChannels; ++ch)
-        {
-            auto smplsF = samplesF[ch];
-            const auto smplsD = samplesD[ch];
-
-            for (auto s = 0; s < numSamples; ++s)
-                smplsF[s] = static_cast<float>(smplsD[s]);
+            chain.getActiveSlot().processBypassed(samples, midiMessages, numChannels, numSamples);
         }
     }
 
-    void Processor::processBlock(AudioBufferD& buffer, MidiBuffer& midiMessages)
+    template<typename Float>
+    void Processor::processBlockChain(ProcessorChain<Float>& chain,
+        juce::AudioBuffer<Float>& buffer, MidiBuffer& midiMessages) noexcept
     {
         juce::ScopedNoDenormals noDenormals;
+        arch::ScopedRealtimeGuard realtimeGuard;
+        const auto start = arch::Telemetry::Clock::now();
+        PPDTraceScope("processBlock");
 		
         const auto numSamplesMain = buffer.getNumSamples();
         {
@@ -279,89 +697,141 @@ namespace audio
         if (numSamplesMain == 0)
             return;
 		
-        const auto numChannels = buffer.getNumChannels();
+        const auto numChannels = std::min(buffer.getNumChannels(), dsp::MaxChannels);
 		auto samplesMain = buffer.getArrayOfWritePointers();
 
-        const auto gainOutDb = static_cast<double>(params(PID::GainOut).getValueDenorm());
+        Float gainOutDb;
+        {
+            PPDTraceScope("parameters");
+            gainOutDb = static_cast<Float>(params(PID::GainOut).getValueDenorm());
+        }
+        const auto hqSwitching = chain.isSwitching();
+        auto smoothing = false;
+        auto numSubBlocks = 0;
 
-        for (auto s = 0; s < numSamplesMain; s += dsp::BlockSize)
+        for (auto s = 0; s < numSamplesMain; s += dsp::BlockSize, ++numSubBlocks)
         {
-            double* samples[] = { &samplesMain[0][s], &samplesMain[1][s] };
+            Float* samples[dsp::MaxChannels];
+            for (auto ch = 0; ch < numChannels; ++ch)
+                samples[ch] = &samplesMain[ch][s];
             const auto dif = numSamplesMain - s;
             const auto numSamples = dif < dsp::BlockSize ? dif : dsp::BlockSize;
 
-            processBlockOversampler(samples, midiMessages, numChannels, numSamples);
+            chain.processOversampled(samples, midiMessages, numChannels, numSamples);
 
-            mixProcessor.join(samples, gainOutDb, numChannels, numSamples);
+            {
+                PPDTraceScope("MixProcessor::join");
+                chain.mixProcessor.join(samples, gainOutDb, numChannels, numSamples);
+            }
+            smoothing = smoothing || chain.mixProcessor.isSmoothing();
         }
 
-
 #if JUCE_DEBUG
         for (auto ch = 0; ch < numChannels; ++ch)
         {
             auto smpls = samplesMain[ch];
             for (auto s = 0; s < numSamplesMain; ++s)
-                smpls[s] = dsp::hardclip(smpls[s], 1.);
+                smpls[s] = dsp::hardclip(smpls[s], static_cast<Float>(1));
         }
 #endif
+
+        telemetry.push(start, numSamplesMain, numSubBlocks, chain.getActiveSlot().getFactor(),
+            hqSwitching || chain.isSwitching(), smoothing);
     }
 
-    void Processor::processBlock(AudioBufferF& buffer, MidiBuffer& midiMessages)
+    void Processor::timerCallback()
     {
-        const auto numChannels = buffer.getNumChannels();
-        const auto numSamples = buffer.getNumSamples();
-
-        audioBufferD.setSize(numChannels, numSamples, true, false, true);
+#if PPDHasHQ
+        // only the chain of the host's precision runs, the other one
+        // gets the config with the next prepareToPlay
+        const auto config = getHQConfig();
+        if (isUsingDoublePrecision())
+        {
+            if (chainD.getTargetConfig() != config)
+                chainD.requestSwitch(config);
+        }
+        else if (chainF.getTargetConfig() != config)
+            chainF.requestSwitch(config);
+#endif
+        updateLatency();
 
-        auto samplesF = buffer.getArrayOfWritePointers();
-        auto samplesD = audioBufferD.getArrayOfWritePointers();
+        updateTimer(isUsingDoublePrecision() ? chainD.isSwitchPending() : chainF.isSwitchPending());
 
-        for (auto ch = 0; ch < numChannels; ++ch)
-        {
-            const auto smplsF = samplesF[ch];
-            auto smplsD = samplesD[ch];
+        telemetry.drain(telemetrySnapshot);
+        telemetryPublisher.publish(telemetrySnapshot);
+    }
 
-            for (auto s = 0; s < numSamples; ++s)
-                smplsD[s] = static_cast<double>(smplsF[s]);
-        }
+    void Processor::updateTimer(bool switching)
+    {
+        const auto hz = switching ? 100 : 4;
+        if (getTimerInterval() != 1000 / hz)
+            startTimerHz(hz);
+    }
 
-        processBlock(audioBufferD, midiMessages);
+    void Processor::updateLatency()
+    {
+        const auto latency = isUsingDoublePrecision() ? chainD.latency.load() : chainF.latency.load();
+        if (latency != getLatencySamples())
+            setLatencySamples(latency);
 
-        for (auto ch = 0; ch < numChannels; ++ch)
+        if (isUsingDoublePrecision())
         {
-            auto smplsF = samplesF[ch];
-            const auto smplsD = samplesD[ch];
-
-            for (auto s = 0; s < numSamples; ++s)
-                smplsF[s] = static_cast<float>(smplsD[s]);
+            const auto& slot = chainD.getActiveSlot();
+            sampleRateUp = slot.sampleRateUp;
+            blockSizeUp = slot.blockSizeUp;
+        }
+        else
+        {
+            const auto& slot = chainF.getActiveSlot();
+            sampleRateUp = slot.sampleRateUp;
+            blockSizeUp = slot.blockSizeUp;
         }
     }
 
-    void Processor::processBlockOversampler(double* const* samples, MidiBuffer& midi,
-        int numChannels, int numSamples) noexcept
+    dsp::OversamplingOrder Processor::getOversamplingOrder() const noexcept
     {
-        auto bufferInfo = oversampler.upsample(samples, numChannels, numSamples);
-        const auto numSamplesUp = bufferInfo.numSamples;
-        double* samplesUp[] = { bufferInfo.smplsL, bufferInfo.smplsR };
-        pluginProcessor(samplesUp, midi, numChannels, numSamplesUp);
-        oversampler.downsample(samples, numSamples);
+#if PPDHasHQ
+        if (params(PID::HQ).getValueDenorm() < .5f)
+            return dsp::OversamplingOrder::x1;
+        const auto order = static_cast<int>(std::round(params(PID::HQFactor).getValueDenorm()));
+        // auto lets the quality decide, what the host's rate needs
+        if (order == 0)
+            return dsp::getOversamplingOrderAuto(getSampleRate(), getOversamplerQuality());
+        return static_cast<dsp::OversamplingOrder>(order);
+#else
+        return dsp::OversamplingOrder::x1;
+#endif
     }
 
-    void Processor::timerCallback()
+    dsp::OversamplerMode Processor::getOversamplerMode() const noexcept
+    {
+#if PPDHasHQ
+        const auto mode = static_cast<int>(std::round(params(PID::HQMode).getValueDenorm()));
+        switch (mode)
+        {
+        case 1: return dsp::OversamplerMode::IIR;
+        case 2: return dsp::OversamplerMode::MinimumPhase;
+        case 3: return dsp::OversamplerMode::Halfband;
+        default: return dsp::OversamplerMode::Polyphase;
+        }
+#else
+        return dsp::OversamplerMode::Polyphase;
+#endif
+    }
+
+    dsp::OversamplerQuality Processor::getOversamplerQuality() const noexcept
     {
-        bool needForcePrepare = false;
-		const auto hqEnabled = params(PID::HQ).getValue() > .5f;
-        if (oversampler.enabled != hqEnabled)
-            needForcePrepare = true;
-        if(needForcePrepare)
-            forcePrepare();
+#if PPDHasHQ
+        const auto quality = static_cast<int>(std::round(params(PID::HQQuality).getValueDenorm()));
+        return static_cast<dsp::OversamplerQuality>(quality);
+#else
+        return dsp::OversamplerQuality::Balanced;
+#endif
     }
 
-    void Processor::forcePrepare()
+    HQConfig Processor::getHQConfig() const noexcept
     {
-        suspendProcessing(true);
-        prepareToPlay(getSampleRate(), getBlockSize());
-        suspendProcessing(false);
+        return { getOversamplingOrder(), getOversamplerMode(), getOversamplerQuality() };
     }
 }
 
@@ -1,7 +1,11 @@
 #pragma once
 #include <juce_audio_processors/juce_audio_processors.h>
+#include <atomic>
 #include "audio/PluginProcessor.h"
 
+#include "arch/RealtimeGuard.h"
+#include "arch/Telemetry.h"
+#include "arch/Trace.h"
 #include "arch/XenManager.h"
 #include "param/Param.h"
 #include "audio/dsp/MixProcessor.h"
@@ -22,6 +26,149 @@ namespace audio
     using Params = param::Params;
     using PID = param::PID;
     using PRM = dsp::PRMD;
+
+    /* what the oversampler is set to */
+    struct HQConfig
+    {
+        bool operator==(const HQConfig&) const noexcept;
+
+        bool operator!=(const HQConfig&) const noexcept;
+
+        dsp::OversamplingOrder order;
+        dsp::OversamplerMode mode;
+        dsp::OversamplerQuality quality;
+    };
+
+    /* the dsp of one pair of channels, that runs at the oversampled rate,
+    with its oversampler. both channels share a Vec2, but not their state */
+    template<typename Float>
+    struct HQLane
+    {
+        HQLane(Params&);
+
+        /* sampleRate, config, allocates */
+        void prepare(double, const HQConfig&);
+
+        /* samples, midi, numChannels[1,2], numSamples */
+        void operator()(Float* const*, MidiBuffer&, int, int) noexcept;
+
+        PluginProcessor<Float> pluginProcessor;
+#if PPDHasHQ
+        dsp::Oversampler<Float> oversampler;
+#endif
+    };
+
+    /* the lanes of all channels with one HQ config */
+    template<typename Float>
+    struct HQSlot
+    {
+        HQSlot(Params&);
+
+        /* sampleRate, numChannels, config, allocates */
+        void prepare(double, int, const HQConfig&);
+
+        /* drops the lanes down to one unprepared lane, allocates */
+        void release();
+
+        /* samples, midi, numChannels, numSamples
+        runs each pair of channels through its own lane. an odd channel out runs alone.
+        only the first lane gets the midi, so that no event is handled once per lane */
+        void operator()(Float* const*, MidiBuffer&, int, int) noexcept;
+
+        /* samples, midi, numChannels, numSamples */
+        void processBypassed(Float* const*, MidiBuffer&, int, int) noexcept;
+
+        /* other, the lanes carry on from where the other slot's lanes are */
+        void copyState(const HQSlot&) noexcept;
+
+        int getLatency() const noexcept;
+
+        /* upsampling factor of the oversampler that runs, 1 without HQ */
+        int getFactor() const noexcept;
+
+        Params& params;
+        // one lane per pair of channels, allocated in prepare
+        std::vector<std::unique_ptr<HQLane<Float>>> lanes;
+        // what the other lanes get instead of the midi. it stays empty, so it never allocates
+        MidiBuffer midiEmpty;
+        HQConfig config;
+        double sampleRateUp;
+        int blockSizeUp;
+    };
+
+    /* the dsp objects of one sample type.
+    float hosts run ProcessorChain<float>, double hosts ProcessorChain<double>.
+    the bench's Lane suites time both, SlewOverBench --verify checks float against double.
+    a new HQ config is prepared in the spare slot on the message thread,
+    while the audio thread keeps running the active one. then the audio thread
+    warms the spare slot up and hands the old one back after the fade.
+    slots of the same latency crossfade. otherwise they'd comb filter while both
+    are heard, so the old one fades out, the new one takes over and fades in */
+    template<typename Float>
+    struct ProcessorChain
+    {
+        static constexpr double FadeLengthMs = 10.;
+        using Buffer = std::array<std::array<Float, dsp::BlockSize>, dsp::MaxChannels>;
+
+        ProcessorChain(Params&
+#if PPDHasTuningEditor
+            , XenManager&
+#endif
+        );
+
+        /* sampleRate, numChannels, config
+        resets both slots and runs the config right away, not while processing */
+        void prepare(double, int, const HQConfig&);
+
+        /* frees the lanes of both slots, when the host runs the other precision.
+        the next prepare brings them back */
+        void release();
+
+        /* config, message thread. prepares the spare slot and hands it to the audio thread.
+        returns false if the last switch isn't done yet */
+        bool requestSwitch(const HQConfig&);
+
+        /* the config that runs, or that is being switched to */
+        HQConfig getTargetConfig() const noexcept;
+
+        /* samples, midi, numChannels, numSamples
+        runs the active slot, fades to the spare one during a switch.
+        latency changes when the spare one takes over */
+        void processOversampled(Float* const*, MidiBuffer&, int, int) noexcept;
+
+        /* while bypassed neither slot is heard, so a pending switch
+        is done right away instead of warming up and fading, audio thread */
+        void completeSwitch() noexcept;
+
+        HQSlot<Float>& getActiveSlot() noexcept;
+
+        const HQSlot<Float>& getActiveSlot() const noexcept;
+
+        /* true while a switch warms up or fades, audio thread */
+        bool isSwitching() const noexcept;
+
+        /* true from requestSwitch until the audio thread is done with the switch, message thread */
+        bool isSwitchPending() const noexcept;
+
+        std::array<HQSlot<Float>, 2> slots;
+        dsp::MixProcessor<Float> mixProcessor;
+        // written by the audio thread when a switch is done, read by the message thread
+        std::atomic<int> latency;
+
+    private:
+        enum class Switch { Idle, WarmUp, Fade, FadeOut, FadeIn };
+
+        Buffer buffer;
+        double sampleRate;
+        int numChannels;
+        std::atomic<int> activeIdx;
+        std::atomic<bool> switchPending;
+        Switch switchState;
+        int switchIdx, numWarmUp, numFade;
+
+        /* the gain of what fades in at switchIdx */
+        Float getFade() const noexcept;
+    };
     
     struct Processor :
         public juce::AudioProcessor,
@@ -43,7 +190,14 @@ namespace audio
         void processBlock(AudioBufferD&, MidiBuffer&) override;
         void processBlockBypassed(AudioBufferD&, MidiBuffer&) override;
 
-        void processBlockOversampler(double* const*, MidiBuffer&, int, int) noexcept;
+        /* chain, buffer, midi */
+        template<typename Float>
+        void processBlockChain(ProcessorChain<Float>&, juce::AudioBuffer<Float>&, MidiBuffer&) noexcept;
+
+        /* chain, buffer, midi */
+        template<typename Float>
+        void processBlockChainBypassed(ProcessorChain<Float>&, juce::AudioBuffer<Float>&, MidiBuffer&) noexcept;
+
         
         juce::AudioProcessorEditor* createEditor() override { return nullptr; }
         bool hasEditor() const override;
@@ -61,7 +215,21 @@ namespace audio
         void setStateInformation(const void*, int) override;
         void timerCallback() override;
         bool supportsDoublePrecisionProcessing() const override;
-        void forcePrepare();
+
+        dsp::OversamplingOrder getOversamplingOrder() const noexcept;
+
+        dsp::OversamplerMode getOversamplerMode() const noexcept;
+
+        dsp::OversamplerQuality getOversamplerQuality() const noexcept;
+
+        HQConfig getHQConfig() const noexcept;
+
+        // hands the latency of the active slots to the host
+        void updateLatency();
+
+        /* switching, polls the chain fast while a switch is pending,
+        so that the host gets the new latency soon after it is heard */
+        void updateTimer(bool);
 
 #if PPDHasTuningEditor
         XenManager xenManager;
@@ -69,14 +237,16 @@ namespace audio
         Params params;
         State state;
 
-        PluginProcessor pluginProcessor;
-        AudioBufferD audioBufferD;
+        ProcessorChain<float> chainF;
+        ProcessorChain<double> chainD;
 
-        dsp::MixProcessor mixProcessor;
-#if PPDHasHQ
-        dsp::Oversampler oversampler;
-#endif
         double sampleRateUp;
         int blockSizeUp;
+
+        // the audio thread fills telemetry, the timer drains it into telemetrySnapshot
+        // and publishes it, if the user settings have publishTelemetry enabled
+        arch::Telemetry telemetry;
+        arch::TelemetrySnapshot telemetrySnapshot;
+        arch::TelemetryPublisher telemetryPublisher;
     };
 }
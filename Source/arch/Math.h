@@ -1,6 +1,10 @@
 #pragma once
 #include <juce_core/juce_core.h>
 #include <juce_graphics/juce_graphics.h>
+#include <bit>
+#if JUCE_INTEL
+#include <emmintrin.h>
+#endif
 
 namespace math
 {
@@ -76,6 +80,99 @@ namespace math
         return std::exp2((note - rootNote) * static_cast<Float>(.08333333333)) * masterTune;
     }
 
+    /* x, 2^x by a polynomial, clamped to [-126, 126].
+    relative error below 3e-7 for float and 1e-8 for double,
+    which is plenty for frequencies */
+    template<typename Float>
+    inline Float exp2Approx(Float x) noexcept
+    {
+        using Int = std::conditional_t<std::is_same_v<Float, float>, std::int32_t, std::int64_t>;
+        static constexpr int MantissaBits = std::is_same_v<Float, float> ? 23 : 52;
+        static constexpr Int Bias = std::is_same_v<Float, float> ? 127 : 1023;
+
+        x = x < static_cast<Float>(-126) ? static_cast<Float>(-126) : x;
+        x = x > static_cast<Float>(126) ? static_cast<Float>(126) : x;
+        // round to nearest, the offset keeps the cast's truncation away from negative numbers
+        const auto i = static_cast<Int>(x + static_cast<Float>(1024.5)) - 1024;
+        // 2^f = e^(f * ln2), f in [-.5, .5]
+        const auto f = (x - static_cast<Float>(i)) * static_cast<Float>(.69314718055994530942);
+        Float y;
+        if constexpr (std::is_same_v<Float, float>)
+            y = 1.f + f * (1.f + f * (.5f + f * (1.f / 6.f + f * (1.f / 24.f + f * (1.f / 120.f + f * (1.f / 720.f))))));
+        else
+            y = 1. + f * (1. + f * (1. / 2. + f * (1. / 6. + f * (1. / 24. + f * (1. / 120. + f * (1. / 720. + f * (1. / 5040.)))))));
+        return y * std::bit_cast<Float>((i + Bias) << MantissaBits);
+    }
+
+#if JUCE_INTEL
+    /* x, exp2Approx of 4 floats at once */
+    inline __m128 exp2Approx(__m128 x) noexcept
+    {
+        x = _mm_max_ps(_mm_min_ps(x, _mm_set1_ps(126.f)), _mm_set1_ps(-126.f));
+        const auto i = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(x, _mm_set1_ps(1024.5f))), _mm_set1_epi32(1024));
+        const auto f = _mm_mul_ps(_mm_sub_ps(x, _mm_cvtepi32_ps(i)), _mm_set1_ps(.69314718056f));
+        const auto term = [f](__m128 y, float c) { return _mm_add_ps(_mm_mul_ps(y, f), _mm_set1_ps(c)); };
+        auto y = term(_mm_set1_ps(1.f / 720.f), 1.f / 120.f);
+        y = term(term(term(y, 1.f / 24.f), 1.f / 6.f), .5f);
+        y = term(term(y, 1.f), 1.f);
+        const auto scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(i, _mm_set1_epi32(127)), 23));
+        return _mm_mul_ps(y, scale);
+    }
+
+    /* x, exp2Approx of 2 doubles at once */
+    inline __m128d exp2Approx(__m128d x) noexcept
+    {
+        x = _mm_max_pd(_mm_min_pd(x, _mm_set1_pd(126.)), _mm_set1_pd(-126.));
+        // the two integers land in the lower lanes of the int32 vector
+        const auto i = _mm_sub_epi32(_mm_cvttpd_epi32(_mm_add_pd(x, _mm_set1_pd(1024.5))), _mm_set1_epi32(1024));
+        const auto f = _mm_mul_pd(_mm_sub_pd(x, _mm_cvtepi32_pd(i)), _mm_set1_pd(.69314718055994530942));
+        const auto term = [f](__m128d y, double c) { return _mm_add_pd(_mm_mul_pd(y, f), _mm_set1_pd(c)); };
+        auto y = term(_mm_set1_pd(1. / 5040.), 1. / 720.);
+        y = term(term(term(y, 1. / 120.), 1. / 24.), 1. / 6.);
+        y = term(term(term(y, .5), 1.), 1.);
+        const auto exponent = _mm_unpacklo_epi32(_mm_add_epi32(i, _mm_set1_epi32(1023)), _mm_setzero_si128());
+        const auto scale = _mm_castsi128_pd(_mm_slli_epi64(exponent, 52));
+        return _mm_mul_pd(y, scale);
+    }
+#endif
+
+    /* buffer, numSamples, rootNote, masterTune
+    converts a block of notes to frequencies in place, the vectorized noteInFreqHz2 */
+    template<typename Float>
+    inline void noteInFreqHz2(Float* buffer, int numSamples, Float rootNote = static_cast<Float>(69), Float masterTune = static_cast<Float>(440)) noexcept
+    {
+        static constexpr auto OctaveInv = static_cast<Float>(.08333333333);
+        auto s = 0;
+#if JUCE_INTEL
+        if constexpr (std::is_same_v<Float, float>)
+        {
+            const auto root = _mm_set1_ps(rootNote);
+            const auto octaveInv = _mm_set1_ps(OctaveInv);
+            const auto tune = _mm_set1_ps(masterTune);
+            for (; s + 4 <= numSamples; s += 4)
+            {
+                const auto note = _mm_loadu_ps(&buffer[s]);
+                const auto freq = exp2Approx(_mm_mul_ps(_mm_sub_ps(note, root), octaveInv));
+                _mm_storeu_ps(&buffer[s], _mm_mul_ps(freq, tune));
+            }
+        }
+        else
+        {
+            const auto root = _mm_set1_pd(rootNote);
+            const auto octaveInv = _mm_set1_pd(OctaveInv);
+            const auto tune = _mm_set1_pd(masterTune);
+            for (; s + 2 <= numSamples; s += 2)
+            {
+                const auto note = _mm_loadu_pd(&buffer[s]);
+                const auto freq = exp2Approx(_mm_mul_pd(_mm_sub_pd(note, root), octaveInv));
+                _mm_storeu_pd(&buffer[s], _mm_mul_pd(freq, tune));
+            }
+        }
+#endif
+        for (; s < numSamples; ++s)
+            buffer[s] = exp2Approx((buffer[s] - rootNote) * OctaveInv) * masterTune;
+    }
+
     template<typename Float>
     inline Float freqHzInNote(Float freqHz, Float rootNote = static_cast<Float>(69), Float xen = static_cast<Float>(12), Float masterTune = static_cast<Float>(440)) noexcept
     {
@@ -0,0 +1,200 @@
+#include "RealtimeGuard.h"
+
+#if PPDHasRealtimeGuard
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#if JUCE_LINUX
+#include <dlfcn.h>
+#include <malloc.h>
+#include <pthread.h>
+#elif JUCE_WINDOWS
+#include <crtdbg.h>
+#endif
+#endif
+
+namespace arch
+{
+#if PPDHasRealtimeGuard
+	namespace realtime
+	{
+		enum State { Unguarded, Guarded, Reporting };
+
+		// plain int, so that touching it doesn't allocate
+		static thread_local int state = Unguarded;
+		static std::atomic<int> numViolations = 0;
+	}
+
+	ScopedRealtimeGuard::ScopedRealtimeGuard() noexcept :
+		prevState(realtime::state)
+	{
+		realtime::state = realtime::Guarded;
+	}
+
+	ScopedRealtimeGuard::~ScopedRealtimeGuard() noexcept
+	{
+		realtime::state = prevState;
+	}
+
+	void checkRealtime(const char* what) noexcept
+	{
+		if (realtime::state != realtime::Guarded)
+			return;
+		// the report itself allocates
+		realtime::state = realtime::Reporting;
+		realtime::numViolations.fetch_add(1, std::memory_order_relaxed);
+		const auto trace = juce::SystemStats::getStackBacktrace();
+		std::fprintf(stderr, "realtime guard: %s on the audio thread\n%s\n", what, trace.toRawUTF8());
+		realtime::state = realtime::Guarded;
+	}
+
+	int getNumRealtimeViolations() noexcept
+	{
+		return realtime::numViolations.load(std::memory_order_relaxed);
+	}
+#else
+	ScopedRealtimeGuard::ScopedRealtimeGuard() noexcept :
+		prevState(0)
+	{
+	}
+
+	ScopedRealtimeGuard::~ScopedRealtimeGuard() noexcept
+	{
+	}
+
+	void checkRealtime(const char*) noexcept
+	{
+	}
+
+	int getNumRealtimeViolations() noexcept
+	{
+		return 0;
+	}
+#endif
+}
+
+#if PPDHasRealtimeGuard
+#if JUCE_LINUX
+// the definitions below only replace libc's in the executable they're linked into.
+// a plugin the host dlopen()s resolves malloc & co. in the global scope, which finds libc first
+
+// glibc's own entry points, so that the definitions below don't call themselves
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void* __libc_memalign(size_t, size_t);
+extern "C" void __libc_free(void*);
+
+extern "C"
+{
+	void* malloc(size_t size)
+	{
+		arch::checkRealtime("malloc");
+		return __libc_malloc(size);
+	}
+
+	void* calloc(size_t num, size_t size)
+	{
+		arch::checkRealtime("calloc");
+		return __libc_calloc(num, size);
+	}
+
+	void* realloc(void* ptr, size_t size)
+	{
+		arch::checkRealtime("realloc");
+		return __libc_realloc(ptr, size);
+	}
+
+	void* aligned_alloc(size_t alignment, size_t size)
+	{
+		arch::checkRealtime("aligned_alloc");
+		return __libc_memalign(alignment, size);
+	}
+
+	int posix_memalign(void** ptr, size_t alignment, size_t size)
+	{
+		arch::checkRealtime("posix_memalign");
+		*ptr = __libc_memalign(alignment, size);
+		return *ptr == nullptr ? ENOMEM : 0;
+	}
+
+	void free(void* ptr)
+	{
+		if (ptr != nullptr)
+			arch::checkRealtime("free");
+		__libc_free(ptr);
+	}
+
+	int pthread_mutex_lock(pthread_mutex_t* mutex)
+	{
+		using Lock = int(*)(pthread_mutex_t*);
+		static Lock lock = nullptr;
+		if (lock == nullptr)
+			lock = reinterpret_cast<Lock>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+		arch::checkRealtime("pthread_mutex_lock");
+		return lock(mutex);
+	}
+}
+#elif JUCE_WINDOWS && defined(_DEBUG)
+// the crt has no hook for locks, so only allocations are seen here
+namespace arch
+{
+	namespace realtime
+	{
+		static int allocHook(int type, void*, size_t, int blockType, long,
+			const unsigned char*, int)
+		{
+			// the crt's own blocks are none of the audio thread's business
+			if (blockType != _CRT_BLOCK)
+				checkRealtime(type == _HOOK_FREE ? "free" : "malloc");
+			return TRUE;
+		}
+
+		static const auto allocHookInstalled = (_CrtSetAllocHook(allocHook), true);
+	}
+}
+#else
+// neither malloc nor locks can be hooked portably, only what goes through operator new and delete is seen
+void* operator new(size_t size)
+{
+	arch::checkRealtime("operator new");
+	if (auto ptr = std::malloc(size))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+	arch::checkRealtime("operator new[]");
+	if (auto ptr = std::malloc(size))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+	if (ptr != nullptr)
+		arch::checkRealtime("operator delete");
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	if (ptr != nullptr)
+		arch::checkRealtime("operator delete[]");
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	operator delete(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+	operator delete[](ptr);
+}
+#endif
+#endif
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+namespace arch
+{
+	/* while one exists on a thread, allocations and frees on that thread are reported
+	with a stack trace and counted, and on linux mutex locks too. a debug/test tool
+	(PPDHasRealtimeGuard), which only does anything if the guard is compiled in:
+	linux: malloc & co. and pthread_mutex_lock, only if linked into the executable (standalone, tests).
+	when a host dlopen()s the plugin (vst3, lv2) the plugin's own calls bind to libc
+	through the global lookup scope, so the guard never fires there
+	windows: malloc & co. with the debug crt, no locks
+	others: operator new and delete, no locks and no malloc */
+	struct ScopedRealtimeGuard
+	{
+		ScopedRealtimeGuard() noexcept;
+
+		~ScopedRealtimeGuard() noexcept;
+
+	private:
+		int prevState;
+	};
+
+	/* what, reports what happened, if the calling thread is guarded */
+	void checkRealtime(const char*) noexcept;
+
+	/* number of reports since the start of the process */
+	int getNumRealtimeViolations() noexcept;
+}
\ No newline at end of file
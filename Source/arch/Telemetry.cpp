@@ -0,0 +1,213 @@
+#include "Telemetry.h"
+#include <new>
+
+#if JUCE_LINUX || JUCE_MAC
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#elif JUCE_WINDOWS
+#include <windows.h>
+#endif
+
+namespace arch
+{
+	Telemetry::Telemetry() :
+		ring(),
+		writeIdx(0),
+		readIdx(0),
+		numDropped(0),
+		resetRequested(false),
+		durationNsWorst(0.),
+		loadWorst(0.f),
+		sampleRate(44100.)
+	{
+	}
+
+	void Telemetry::prepare(double _sampleRate) noexcept
+	{
+		sampleRate.store(_sampleRate, std::memory_order_relaxed);
+		resetRequested.store(true, std::memory_order_release);
+	}
+
+	void Telemetry::push(Clock::time_point start, int numSamples, int numSubBlocks,
+		int hqFactor, bool hqSwitching, bool smoothing) noexcept
+	{
+		const auto durationNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+		const auto deadlineNs = static_cast<double>(numSamples) * 1e9 / sampleRate.load(std::memory_order_relaxed);
+		const auto load = static_cast<float>(durationNs / deadlineNs);
+
+		if (resetRequested.exchange(false, std::memory_order_acq_rel))
+		{
+			durationNsWorst.store(0., std::memory_order_relaxed);
+			loadWorst.store(0.f, std::memory_order_relaxed);
+		}
+		if (durationNs > durationNsWorst.load(std::memory_order_relaxed))
+			durationNsWorst.store(durationNs, std::memory_order_relaxed);
+		if (load > loadWorst.load(std::memory_order_relaxed))
+			loadWorst.store(load, std::memory_order_relaxed);
+
+		const auto w = writeIdx.load(std::memory_order_relaxed);
+		if (w - readIdx.load(std::memory_order_acquire) >= static_cast<std::uint32_t>(Size))
+		{
+			numDropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		ring[w & (Size - 1)] = { durationNs, load, numSamples, numSubBlocks, hqFactor, hqSwitching, smoothing };
+		writeIdx.store(w + 1, std::memory_order_release);
+	}
+
+	void Telemetry::drain(TelemetrySnapshot& snapshot) noexcept
+	{
+		const auto r = readIdx.load(std::memory_order_relaxed);
+		const auto w = writeIdx.load(std::memory_order_acquire);
+
+		snapshot.version = TelemetrySnapshot::Version;
+		snapshot.sampleRate = sampleRate.load(std::memory_order_relaxed);
+		snapshot.durationNsMax = 0.;
+		snapshot.loadMax = 0.f;
+		auto loadSum = 0.;
+		for (auto i = r; i != w; ++i)
+		{
+			const auto& stats = ring[i & (Size - 1)];
+			loadSum += stats.load;
+			if (stats.durationNs > snapshot.durationNsMax)
+				snapshot.durationNsMax = stats.durationNs;
+			if (stats.load > snapshot.loadMax)
+				snapshot.loadMax = stats.load;
+			snapshot.numSamples = stats.numSamples;
+			snapshot.numSubBlocks = stats.numSubBlocks;
+			snapshot.hqFactor = stats.hqFactor;
+			snapshot.hqSwitching = stats.hqSwitching ? 1 : 0;
+			snapshot.smoothing = stats.smoothing ? 1 : 0;
+		}
+		const auto numBlocks = static_cast<std::int64_t>(w - r);
+		snapshot.loadAvg = numBlocks != 0 ? static_cast<float>(loadSum / static_cast<double>(numBlocks)) : 0.f;
+		snapshot.numBlocks += numBlocks;
+		snapshot.numDropped = numDropped.load(std::memory_order_relaxed);
+		snapshot.durationNsWorst = durationNsWorst.load(std::memory_order_relaxed);
+		snapshot.loadWorst = loadWorst.load(std::memory_order_relaxed);
+
+		readIdx.store(w, std::memory_order_release);
+	}
+
+	void Telemetry::resetWorst() noexcept
+	{
+		resetRequested.store(true, std::memory_order_release);
+	}
+
+	TelemetryPublisher::TelemetryPublisher() :
+		name(),
+		shared(nullptr),
+		handle(nullptr)
+	{
+	}
+
+	TelemetryPublisher::~TelemetryPublisher()
+	{
+		close();
+	}
+
+	bool TelemetryPublisher::open()
+	{
+		if (isOpen())
+			return true;
+
+		static std::atomic<int> numInstances = 0;
+		const auto instance = numInstances.fetch_add(1);
+		name = "SlewOverTelemetry." + juce::String(juce::Process::getProcessID()) + "." + juce::String(instance);
+		const auto size = sizeof(TelemetrySnapshot);
+		void* memory = nullptr;
+
+#if JUCE_LINUX || JUCE_MAC
+		const auto path = "/" + name;
+		const auto fd = shm_open(path.toRawUTF8(), O_CREAT | O_RDWR, 0644);
+		if (fd == -1)
+			return false;
+		if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+		{
+			memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			if (memory == MAP_FAILED)
+				memory = nullptr;
+		}
+		// the mapping keeps the segment alive
+		::close(fd);
+		if (memory == nullptr)
+		{
+			shm_unlink(path.toRawUTF8());
+			return false;
+		}
+#elif JUCE_WINDOWS
+		const auto path = "Local\\" + name;
+		const auto mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+			0, static_cast<DWORD>(size), path.toWideCharPointer());
+		if (mapping == nullptr)
+			return false;
+		memory = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+		if (memory == nullptr)
+		{
+			CloseHandle(mapping);
+			return false;
+		}
+		handle = mapping;
+#else
+		return false;
+#endif
+
+		shared = new (memory) TelemetrySnapshot();
+		shared->version = TelemetrySnapshot::Version;
+		return true;
+	}
+
+	void TelemetryPublisher::close()
+	{
+		if (!isOpen())
+			return;
+
+#if JUCE_LINUX || JUCE_MAC
+		munmap(shared, sizeof(TelemetrySnapshot));
+		shm_unlink(("/" + name).toRawUTF8());
+#elif JUCE_WINDOWS
+		UnmapViewOfFile(shared);
+		CloseHandle(static_cast<HANDLE>(handle));
+#endif
+		shared = nullptr;
+		handle = nullptr;
+	}
+
+	bool TelemetryPublisher::isOpen() const noexcept
+	{
+		return shared != nullptr;
+	}
+
+	void TelemetryPublisher::publish(const TelemetrySnapshot& snapshot) noexcept
+	{
+		if (!isOpen())
+			return;
+
+		auto& dest = *shared;
+		const auto sequence = dest.sequence.load(std::memory_order_relaxed);
+		dest.sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		dest.numBlocks = snapshot.numBlocks;
+		dest.numDropped = snapshot.numDropped;
+		dest.sampleRate = snapshot.sampleRate;
+		dest.durationNsMax = snapshot.durationNsMax;
+		dest.loadAvg = snapshot.loadAvg;
+		dest.loadMax = snapshot.loadMax;
+		dest.durationNsWorst = snapshot.durationNsWorst;
+		dest.loadWorst = snapshot.loadWorst;
+		dest.numSamples = snapshot.numSamples;
+		dest.numSubBlocks = snapshot.numSubBlocks;
+		dest.hqFactor = snapshot.hqFactor;
+		dest.hqSwitching = snapshot.hqSwitching;
+		dest.smoothing = snapshot.smoothing;
+
+		dest.sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	const juce::String& TelemetryPublisher::getName() const noexcept
+	{
+		return name;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace arch
+{
+	/* what the audio thread measured in one processBlock */
+	struct BlockStats
+	{
+		// wall time of the block
+		double durationNs;
+		// durationNs as a fraction of the block's length in real time, 1 = just made the deadline
+		float load;
+		int numSamples, numSubBlocks;
+		// oversampling factor of the active HQ slot
+		int hqFactor;
+		bool hqSwitching, smoothing;
+	};
+
+	/* what a reader made of all blocks since its last drain, a plain struct without pointers,
+	so that it can live in shared memory */
+	struct TelemetrySnapshot
+	{
+		static constexpr std::uint32_t Version = 1;
+
+		std::uint32_t version;
+		// odd while the writer is busy. readers retry until it is even and unchanged
+		std::atomic<std::uint32_t> sequence;
+		std::int64_t numBlocks, numDropped;
+		double sampleRate;
+		// of the blocks since the last drain
+		double durationNsMax;
+		float loadAvg, loadMax;
+		// since the last reset
+		double durationNsWorst;
+		float loadWorst;
+		// of the last block
+		std::int32_t numSamples, numSubBlocks, hqFactor, hqSwitching, smoothing;
+	};
+
+	/* lock-free ring of BlockStats between the audio thread and one reader.
+	the audio thread only writes its slot and an index, so it never waits.
+	if the reader falls behind, new blocks are dropped and counted */
+	struct Telemetry
+	{
+		static constexpr int Size = 1 << 11;
+		using Clock = std::chrono::steady_clock;
+
+		Telemetry();
+
+		/* sampleRate, before processing */
+		void prepare(double) noexcept;
+
+		/* start, numSamples, numSubBlocks, hqFactor, hqSwitching, smoothing, audio thread */
+		void push(Clock::time_point, int, int, int, bool, bool) noexcept;
+
+		/* snapshot, reader thread. folds all blocks since the last drain into snapshot */
+		void drain(TelemetrySnapshot&) noexcept;
+
+		/* reader thread, the audio thread starts the worst case over with its next block */
+		void resetWorst() noexcept;
+
+	private:
+		std::array<BlockStats, Size> ring;
+		// count up and wrap around, Size divides 2^32, so w - r is the fill level either way
+		std::atomic<std::uint32_t> writeIdx, readIdx;
+		std::atomic<std::int64_t> numDropped;
+		std::atomic<bool> resetRequested;
+		// written by the audio thread only
+		std::atomic<double> durationNsWorst;
+		std::atomic<float> loadWorst;
+		// written by prepare, read by both threads
+		std::atomic<double> sampleRate;
+	};
+
+	/* a named shared memory segment with one TelemetrySnapshot in it,
+	so that a monitor can watch every instance on the machine.
+	linux and mac: /dev/shm/SlewOverTelemetry.<pid>.<instance>, windows: Local\SlewOverTelemetry.<pid>.<instance> */
+	struct TelemetryPublisher
+	{
+		TelemetryPublisher();
+
+		~TelemetryPublisher();
+
+		/* creates the segment, message thread. returns false if the os doesn't let it */
+		bool open();
+
+		void close();
+
+		bool isOpen() const noexcept;
+
+		/* snapshot, copies it into the segment */
+		void publish(const TelemetrySnapshot&) noexcept;
+
+		const juce::String& getName() const noexcept;
+
+	private:
+		juce::String name;
+		TelemetrySnapshot* shared;
+		void* handle;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include "Trace.h"
+
+#if PPDHasTracing
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#endif
+
+namespace arch
+{
+	namespace trace
+	{
+#if PPDHasTracing
+		struct Event
+		{
+			// the ring position this slot is ready to be written for, or +1 when written
+			std::atomic<std::uint64_t> sequence;
+			const char* name;
+			std::uint64_t begin, end;
+			std::uint32_t threadId;
+		};
+
+		/* bounded ring of many writers and one reader. writers claim a position with one
+		fetch_add, a slot is readable once its sequence says so */
+		struct Ring
+		{
+			static constexpr std::uint64_t Size = 1 << 16;
+
+			Ring() :
+				events(),
+				writeIdx(0),
+				readIdx(0)
+			{
+				for (std::uint64_t i = 0; i < Size; ++i)
+					events[i].sequence.store(i, std::memory_order_relaxed);
+			}
+
+			void push(const char* name, std::uint64_t begin, std::uint64_t end, std::uint32_t threadId) noexcept
+			{
+				auto pos = writeIdx.load(std::memory_order_relaxed);
+				while (true)
+				{
+					auto& event = events[pos & (Size - 1)];
+					const auto sequence = event.sequence.load(std::memory_order_acquire);
+					if (sequence == pos)
+					{
+						if (writeIdx.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						{
+							event.name = name;
+							event.begin = begin;
+							event.end = end;
+							event.threadId = threadId;
+							event.sequence.store(pos + 1, std::memory_order_release);
+							return;
+						}
+					}
+					else if (sequence < pos)
+						return; // full, the writer thread is behind
+					else
+						pos = writeIdx.load(std::memory_order_relaxed);
+				}
+			}
+
+			/* visit(name, begin, end, threadId), reader thread */
+			template<typename Visit>
+			void drain(Visit&& visit)
+			{
+				while (true)
+				{
+					auto& event = events[readIdx & (Size - 1)];
+					if (event.sequence.load(std::memory_order_acquire) != readIdx + 1)
+						return;
+					visit(event.name, event.begin, event.end, event.threadId);
+					event.sequence.store(readIdx + Size, std::memory_order_release);
+					++readIdx;
+				}
+			}
+
+		private:
+			std::array<Event, Size> events;
+			std::atomic<std::uint64_t> writeIdx;
+			std::uint64_t readIdx;
+		};
+
+		/* drains the ring into the file every few milliseconds */
+		struct Writer
+		{
+			static constexpr int IntervalMs = 20;
+
+			Writer(const juce::File& file) :
+				ring(std::make_unique<Ring>()),
+				stream(file),
+				text(),
+				mutex(),
+				wakeUp(),
+				thread(),
+				running(true),
+				ticks0(now()),
+				time0(std::chrono::steady_clock::now()),
+				numEvents(0),
+				pid(juce::String(juce::Process::getProcessID()).toStdString())
+			{
+				if (stream.openedOk())
+				{
+					stream.setPosition(0);
+					stream.truncate();
+					stream.writeText("[\n", false, false, nullptr);
+				}
+				thread = std::thread([this]() { run(); });
+			}
+
+			~Writer()
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					running = false;
+				}
+				wakeUp.notify_one();
+				thread.join();
+				flush();
+				if (stream.openedOk())
+					stream.writeText("\n]\n", false, false, nullptr);
+			}
+
+			void run()
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				while (running)
+				{
+					wakeUp.wait_for(lock, std::chrono::milliseconds(IntervalMs));
+					flush();
+				}
+			}
+
+			void flush()
+			{
+				// ticks per microsecond, measured over the whole session so far
+				const auto elapsedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - time0).count();
+				const auto elapsedTicks = static_cast<double>(now() - ticks0);
+				const auto ticksPerUs = elapsedUs > 0. && elapsedTicks > 0. ? elapsedTicks / elapsedUs : 1000.;
+
+				text.clear();
+				ring->drain([&](const char* name, std::uint64_t begin, std::uint64_t end, std::uint32_t threadId)
+				{
+					const auto ts = static_cast<double>(begin - ticks0) / ticksPerUs;
+					const auto dur = static_cast<double>(end - begin) / ticksPerUs;
+					char event[256];
+					std::snprintf(event, sizeof(event),
+						"%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%s,\"tid\":%u}",
+						numEvents == 0 ? "" : ",\n", name, ts, dur, pid.c_str(), threadId);
+					text += event;
+					++numEvents;
+				});
+				if (!text.empty() && stream.openedOk())
+				{
+					stream.write(text.data(), text.size());
+					stream.flush();
+				}
+			}
+
+			std::unique_ptr<Ring> ring;
+			juce::FileOutputStream stream;
+			std::string text;
+			std::mutex mutex;
+			std::condition_variable wakeUp;
+			std::thread thread;
+			bool running;
+			std::uint64_t ticks0;
+			std::chrono::steady_clock::time_point time0;
+			std::int64_t numEvents;
+			std::string pid;
+		};
+
+		static std::mutex writerMutex;
+		static std::unique_ptr<Writer> writer;
+		static int numUsers = 0;
+		// what the audio threads see of writer
+		static std::atomic<Ring*> ring = nullptr;
+		static std::atomic<std::uint32_t> numThreads = 0;
+
+		void record(const char* name, std::uint64_t begin, std::uint64_t end) noexcept
+		{
+			const auto r = ring.load(std::memory_order_acquire);
+			if (r == nullptr)
+				return;
+			static thread_local std::uint32_t threadId = 0;
+			if (threadId == 0)
+				threadId = numThreads.fetch_add(1, std::memory_order_relaxed) + 1;
+			r->push(name, begin, end, threadId);
+		}
+
+		void start(const juce::File& file)
+		{
+			std::lock_guard<std::mutex> lock(writerMutex);
+			if (numUsers++ != 0)
+				return;
+			writer = std::make_unique<Writer>(file);
+			ring.store(writer->ring.get(), std::memory_order_release);
+		}
+
+		void stop()
+		{
+			std::lock_guard<std::mutex> lock(writerMutex);
+			if (numUsers == 0 || --numUsers != 0)
+				return;
+			// audio threads that still hold the ring are done with it once their processBlock
+			// returns, which happened before the last processor is destroyed
+			ring.store(nullptr, std::memory_order_release);
+			writer.reset();
+		}
+#else
+		void record(const char*, std::uint64_t, std::uint64_t) noexcept
+		{
+		}
+
+		void start(const juce::File&)
+		{
+		}
+
+		void stop()
+		{
+		}
+#endif
+	}
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <chrono>
+#include <cstdint>
+
+#if PPDHasTracing && JUCE_INTEL
+#if JUCE_MSVC
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace arch
+{
+	/* scoped trace points, that a background thread writes into a chrome trace
+	(chrome://tracing, ui.perfetto.dev). a debug/profiling tool (PPDHasTracing),
+	without it the trace points compile to nothing and start/stop do nothing */
+	namespace trace
+	{
+		/* cpu timestamp counter, or nanoseconds of the steady clock without one */
+		inline std::uint64_t now() noexcept
+		{
+#if PPDHasTracing && JUCE_INTEL
+			return __rdtsc();
+#else
+			const auto time = std::chrono::steady_clock::now().time_since_epoch();
+			return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+#endif
+		}
+
+		/* name, begin, end; name must be a string literal. lock-free, any thread.
+		dropped if tracing didn't start or the writer falls behind */
+		void record(const char*, std::uint64_t, std::uint64_t) noexcept;
+
+		/* file, starts writing the trace with the first call. every call needs a stop */
+		void start(const juce::File&);
+
+		/* the last one finishes the file */
+		void stop();
+
+		struct Scope
+		{
+			/* name, a string literal */
+			Scope(const char* _name) noexcept :
+				name(_name),
+				begin(now())
+			{
+			}
+
+			~Scope() noexcept
+			{
+				record(name, begin, now());
+			}
+
+		private:
+			const char* name;
+			std::uint64_t begin;
+		};
+	}
+}
+
+#define PPDTraceConcat2(a, b) a##b
+#define PPDTraceConcat(a, b) PPDTraceConcat2(a, b)
+
+#if PPDHasTracing
+// traces the rest of the enclosing scope under name
+#define PPDTraceScope(name) const arch::trace::Scope PPDTraceConcat(traceScope, __LINE__)(name)
+#else
+#define PPDTraceScope(name)
+#endif
\ No newline at end of file
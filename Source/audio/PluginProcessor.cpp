@@ -1,35 +1,223 @@
 #include "PluginProcessor.h"
 #include "dsp/Distortion.h"
 #include "../arch/Math.h"
+#include "../arch/Trace.h"
 
 namespace audio
 {
-	PluginProcessor::PluginProcessor(Params& _params) :
+	template<typename Float>
+	PluginProcessor<Float>::PluginProcessor(Params& _params) :
 		params(_params),
-		sampleRate(1.)
+		sampleRate(1.),
+		slew(),
+		slewBands(),
+		crossover(),
+		slewRisePRM(static_cast<Float>(params(PID::Slew).getValueDenorm())),
+		slewFallPRM(static_cast<Float>(params(PID::SlewFall).getValueDenorm())),
+		riseBand(),
+		fallBand()
 	{
 	}
 
-	void PluginProcessor::prepare(double _sampleRate)
+	template<typename Float>
+	void PluginProcessor<Float>::prepare(double _sampleRate)
 	{
 		sampleRate = _sampleRate;
+		slew.prepare(static_cast<Float>(sampleRate));
+		for (auto& slewBand : slewBands)
+			slewBand.prepare(static_cast<Float>(sampleRate));
+		crossover.prepare(static_cast<Float>(sampleRate), getNumBands());
+		const auto linked = params(PID::SlewLink).getValueDenorm() > .5f;
+		const auto rise = params(PID::Slew).getValueDenorm();
+		const auto fall = linked ? rise : params(PID::SlewFall).getValueDenorm();
+		for (auto prm : { &slewRisePRM, &slewFallPRM })
+			prm->prepare(static_cast<Float>(sampleRate), static_cast<Float>(SlewSmoothLengthMs));
+		slewRisePRM.reset(static_cast<Float>(rise));
+		slewFallPRM.reset(static_cast<Float>(fall));
 	}
 
-	void PluginProcessor::operator()(double** samples, dsp::MidiBuffer&, int numChannels, int numSamples) noexcept
+	template<typename Float>
+	void PluginProcessor<Float>::operator()(Float* const* samples, dsp::MidiBuffer&, int numChannels, int numSamples) noexcept
 	{
-		const auto slewPitch = params(PID::Slew).getValueDenorm();
-		const auto slewHz = math::noteInFreqHz2(slewPitch);
-		const auto slewRate = slew.freqHzToSlewRate(slewHz, sampleRate);
-		const auto type = int(std::round(params(PID::FilterType).getValueDenorm()));
-		slew(samples, slewRate, numChannels, numSamples, dsp::SlewLimiter::Type(type));
+		FilterType filterType;
+		int order, numBands;
+		const auto rates = [&]()
+		{
+			PPDTraceScope("parameters");
+			filterType = getFilterType();
+			order = getOrder();
+			numBands = getNumBands();
+			typename dsp::Crossover<Float, MaxBands>::Frequencies frequencies;
+			for (auto i = 0; i < MaxBands - 1; ++i)
+				frequencies[i] = static_cast<Float>(params(param::offset(PID::Crossover1, i)).getValueDenorm());
+			crossover.setFrequencies(frequencies);
+			return getSlewRates(numSamples);
+		}();
+		// the crossover runs until a change to one band has faded out
+		if (numBands > 1 || crossover.getNumBands() > 1)
+			processBands(samples, rates, numChannels, numSamples, filterType, order, numBands);
+		else if (rates.smoothing)
+			slew(samples, rates.rise.buf, rates.fall.buf, numChannels, numSamples, filterType, order);
+		else
+			slew(samples, rates.rise.val, rates.fall.val, numChannels, numSamples, filterType, order);
 	}
 
-	void PluginProcessor::processBlockBypassed(double**, dsp::MidiBuffer&, int, int) noexcept
+	template<typename Float>
+	void PluginProcessor<Float>::operator()(dsp::Oversampler<Float>& oversampler, Float* const* samples,
+		dsp::MidiBuffer&, int numChannels, int numSamples) noexcept
+	{
+		FilterType filterType;
+		int order;
+		const auto rates = [&]()
+		{
+			PPDTraceScope("parameters");
+			filterType = getFilterType();
+			order = getOrder();
+			// the slew limiter runs at the oversampled rate in here
+			return getSlewRates(numSamples * oversampler.getFactor());
+		}();
+		if (rates.smoothing)
+			slew(oversampler, samples, rates.rise.buf, rates.fall.buf, numChannels, numSamples, filterType, order);
+		else
+			slew(oversampler, samples, rates.rise.val, rates.fall.val, numChannels, numSamples, filterType, order);
+	}
+
+	template<typename Float>
+	bool PluginProcessor<Float>::canFuse() const noexcept
+	{
+		return getNumBands() == 1 && crossover.getNumBands() == 1;
+	}
+
+	template<typename Float>
+	void PluginProcessor<Float>::copyState(const PluginProcessor& other) noexcept
+	{
+		slew.copyState(other.slew);
+		for (auto b = 0; b < MaxBands - 1; ++b)
+			slewBands[b].copyState(other.slewBands[b]);
+	}
+
+	template<typename Float>
+	void PluginProcessor<Float>::processBands(Float* const* samples, const SlewRates& rates,
+		int numChannels, int numSamples, FilterType filterType, int order, int numBands) noexcept
+	{
+		std::array<Float, MaxBands> ratios;
+		for (auto b = 0; b < MaxBands; ++b)
+		{
+			const auto semi = params(param::offset(PID::BandSlew1, b)).getValueDenorm();
+			ratios[b] = static_cast<Float>(std::exp2(semi / 12.f));
+		}
+
+		for (auto s = 0; s < numSamples; s += dsp::BlockSize)
+		{
+			const auto numSamplesBlock = std::min(numSamples - s, dsp::BlockSize);
+			Float* block[] = { samples[0] + s, samples[numChannels - 1] + s };
+			{
+				PPDTraceScope("crossover split");
+				const auto numBandsPrev = crossover.getNumBands();
+				crossover.split(block, numChannels, numSamplesBlock, numBands);
+				// bands that join in fade in from silence
+				for (auto b = numBandsPrev; b < crossover.getNumBands(); ++b)
+					slewBands[b - 1].reset();
+			}
+			for (auto b = 0; b < crossover.getNumBands(); ++b)
+			{
+				typename dsp::Crossover<Float, MaxBands>::Band band = { block[0], block[1] };
+				if (b != 0)
+					band = crossover.getBand(b);
+				auto& slewBand = b == 0 ? slew : slewBands[b - 1];
+				const auto ratio = ratios[b];
+				if (!rates.smoothing)
+				{
+					slewBand(band.data(), rates.rise.val * ratio, rates.fall.val * ratio,
+						numChannels, numSamplesBlock, filterType, order);
+					continue;
+				}
+				for (auto i = 0; i < numSamplesBlock; ++i)
+				{
+					riseBand[i] = rates.rise.buf[s + i] * ratio;
+					fallBand[i] = rates.fall.buf[s + i] * ratio;
+				}
+				slewBand(band.data(), riseBand.data(), fallBand.data(),
+					numChannels, numSamplesBlock, filterType, order);
+			}
+			PPDTraceScope("crossover join");
+			crossover.join(block, numChannels, numSamplesBlock);
+		}
+	}
+
+	template<typename Float>
+	typename PluginProcessor<Float>::SlewRates PluginProcessor<Float>::getSlewRates(int numSamples) noexcept
+	{
+		const auto risePitch = static_cast<Float>(params(PID::Slew).getValueDenorm());
+		const auto rise = getSlewRates(slewRisePRM, risePitch, numSamples);
+		if (params(PID::SlewLink).getValueDenorm() > .5f)
+		{
+			// the fall follows the rise, and glides away from it once unlinked
+			slewFallPRM.reset(risePitch);
+			return { rise, rise, rise.smoothing };
+		}
+
+		const auto fallPitch = static_cast<Float>(params(PID::SlewFall).getValueDenorm());
+		SlewRates rates = { rise, getSlewRates(slewFallPRM, fallPitch, numSamples), false };
+		rates.smoothing = rates.rise.smoothing || rates.fall.smoothing;
+		if (rates.smoothing)
+		{
+			rates.rise.copyToBuffer(numSamples);
+			rates.fall.copyToBuffer(numSamples);
+		}
+		return rates;
+	}
+
+	template<typename Float>
+	dsp::PRMInfo<Float> PluginProcessor<Float>::getSlewRates(SlewPRM& prm, Float pitch, int numSamples) noexcept
+	{
+		auto info = prm(pitch, numSamples);
+		const auto sampleRateF = static_cast<Float>(sampleRate);
+		if (!info.smoothing)
+		{
+			info.val = slew.freqHzToSlewRate(math::noteInFreqHz2(info.val), sampleRateF);
+			return info;
+		}
+		// freqHzToSlewRate divides by the sample rate, which is folded into the tuning here
+		const auto masterTune = slew.freqHzToSlewRate(static_cast<Float>(440), sampleRateF);
+		math::noteInFreqHz2(info.buf, numSamples, static_cast<Float>(69), masterTune);
+		return info;
+	}
+
+	template<typename Float>
+	typename PluginProcessor<Float>::FilterType PluginProcessor<Float>::getFilterType() const noexcept
+	{
+		if (params(PID::BandPass).getValueDenorm() > .5f)
+			return FilterType::BP;
+		return static_cast<FilterType>(std::round(params(PID::FilterType).getValueDenorm()));
+	}
+
+	template<typename Float>
+	int PluginProcessor<Float>::getOrder() const noexcept
+	{
+		const auto order = static_cast<int>(std::round(params(PID::SlewOrder).getValueDenorm()));
+		return std::clamp(order, 1, dsp::SlewLimiterStereo<Float>::MaxOrder);
+	}
+
+	template<typename Float>
+	int PluginProcessor<Float>::getNumBands() const noexcept
+	{
+		const auto numBands = static_cast<int>(std::round(params(PID::Bands).getValueDenorm()));
+		return std::clamp(numBands, 1, MaxBands);
+	}
+
+	template<typename Float>
+	void PluginProcessor<Float>::processBlockBypassed(Float* const*, dsp::MidiBuffer&, int, int) noexcept
 	{}
 
-	void PluginProcessor::savePatch()
+	template<typename Float>
+	void PluginProcessor<Float>::savePatch()
 	{}
 
-	void PluginProcessor::loadPatch()
+	template<typename Float>
+	void PluginProcessor<Float>::loadPatch()
 	{}
-}
\ No newline at end of file
+
+	template struct PluginProcessor<float>;
+	template struct PluginProcessor<double>;
+}
@@ -1,6 +1,9 @@
 #pragma once
 #include "../param/Param.h"
 #include "dsp/SlewLimiter.h"
+#include "dsp/Crossover.h"
+#include "dsp/Oversampler.h"
+#include "dsp/PRM.h"
 #include "Using.h"
 
 /*
@@ -9,10 +12,14 @@ This is where dsp custom to each individual plugin will be written
 
 namespace audio
 {
+	template<typename Float>
 	struct PluginProcessor
 	{
 		using Params = param::Params;
 		using PID = param::PID;
+		using FilterType = typename dsp::SlewLimiterStereo<Float>::Type;
+		static constexpr double SlewSmoothLengthMs = 13.;
+		static constexpr int MaxBands = 5;
 		
 		PluginProcessor(Params&);
 
@@ -20,10 +27,21 @@ namespace audio
 		void prepare(double);
 
 		/* samples, midiBuffer, numChannels, numSamples */
-		void operator()(double**, dsp::MidiBuffer&, int, int) noexcept;
+		void operator()(Float* const*, dsp::MidiBuffer&, int, int) noexcept;
+
+		/* oversampler, samples, midiBuffer, numChannels, numSamples
+		oversamples and processes in one loop. only if canFuse */
+		void operator()(dsp::Oversampler<Float>&, Float* const*, dsp::MidiBuffer&, int, int) noexcept;
+
+		/* true if the dsp is the plain slew limiter, which works sample by sample.
+		the crossover of more than one band works block by block, also while it fades to one */
+		bool canFuse() const noexcept;
+
+		/* other, takes over the slew limiters' outputs, like when the oversampling changes */
+		void copyState(const PluginProcessor&) noexcept;
 		
 		/* samples, midiBuffer, numChannels, numSamples */
-		void processBlockBypassed(double**, dsp::MidiBuffer&, int, int) noexcept;
+		void processBlockBypassed(Float* const*, dsp::MidiBuffer&, int, int) noexcept;
 
 		void savePatch();
 		
@@ -32,6 +50,47 @@ namespace audio
 		Params& params;
 		double sampleRate;
 
-		dsp::SlewLimiterStereo slew;
+		// slew limits band 0, or everything if there is one band
+		dsp::SlewLimiterStereo<Float> slew;
+		// of the bands above band 0
+		std::array<dsp::SlewLimiterStereo<Float>, MaxBands - 1> slewBands;
+		dsp::Crossover<Float, MaxBands> crossover;
+		// smooth the slew parameters in pitch, at the rate the slew limiter runs at
+		dsp::PRM<Float, dsp::BlockSize16x> slewRisePRM, slewFallPRM;
+
+	private:
+		using SlewPRM = dsp::PRM<Float, dsp::BlockSize16x>;
+
+		struct SlewRates
+		{
+			dsp::PRMInfo<Float> rise, fall;
+			// if true both buffers hold values, otherwise both vals do
+			bool smoothing;
+		};
+
+		// the rise and fall rates of one band while smoothing
+		std::array<Float, dsp::BlockSize> riseBand, fallBand;
+
+		/* numSamples, the rise and fall rates of the next numSamples samples */
+		SlewRates getSlewRates(int) noexcept;
+
+		/* prm, pitch, numSamples, the slew rates of the next numSamples samples.
+		their buffer only holds values while smoothing, val otherwise */
+		dsp::PRMInfo<Float> getSlewRates(SlewPRM&, Float, int) noexcept;
+
+		FilterType getFilterType() const noexcept;
+
+		/* the number of slew limiters in series */
+		int getOrder() const noexcept;
+
+		/* the number of bands the crossover splits into */
+		int getNumBands() const noexcept;
+
+		/* samples, rates, numChannels, numSamples, filterType, order, numBands
+		splits each BlockSize samples into bands, slew limits each one at its rate and sums them back */
+		void processBands(Float* const*, const SlewRates&, int, int, FilterType, int, int) noexcept;
 	};
-}
\ No newline at end of file
+
+	using PluginProcessorF = PluginProcessor<float>;
+	using PluginProcessorD = PluginProcessor<double>;
+}
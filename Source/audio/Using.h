@@ -15,15 +15,30 @@ namespace dsp
 	using MidiBuffer = juce::MidiBuffer;
 	using MidiMessage = juce::MidiMessage;
 	using SIMD = juce::FloatVectorOperations;
-	using AudioBuffer = juce::AudioBuffer<double>;
+	template<typename Float>
+	using AudioBuffer = juce::AudioBuffer<Float>;
 	using Uint8 = uint8_t;
 	
 	static constexpr int NumMIDIChannels = 16;
 	static constexpr int NumMPEChannels = NumMIDIChannels - 1;
 	static constexpr double PitchbendRange = 16383.;
 	static constexpr double PitchbendRangeHalf = PitchbendRange * .5;
+
+	/* data, 1-16, or 0 for system messages. reads the raw bytes, because
+	MidiMessage allocates for anything longer than a few bytes (sysex) */
+	inline int getMIDIChannel(const Uint8* data) noexcept
+	{
+		return (data[0] & 0xf0) == 0xf0 ? 0 : (data[0] & 0x0f) + 1;
+	}
+
+	/* data */
+	inline bool isNoteOnOrOff(const Uint8* data) noexcept
+	{
+		const auto status = data[0] & 0xf0;
+		return status == 0x80 || status == 0x90;
+	}
 	
-	enum class OversamplingOrder { x1, x2, x4, NumOrders };
+	enum class OversamplingOrder { x1, x2, x4, x8, x16, NumOrders };
 	inline constexpr int getOversamplingFactor(OversamplingOrder order) noexcept
 	{
 		switch (order)
@@ -31,14 +46,24 @@ namespace dsp
 			case OversamplingOrder::x1: return 1;
 			case OversamplingOrder::x2: return 2;
 			case OversamplingOrder::x4: return 4;
+			case OversamplingOrder::x8: return 8;
+			case OversamplingOrder::x16: return 16;
 			default: return 1;
 		}
 	}
 
 	static constexpr int NumChannels = PPDHasSidechain ? 4 : 2;
-    static constexpr int BlockSize = 32;
+	// channels of the main bus. the dsp runs on pairs of them, one per Vec2
+	static constexpr int MaxChannels = 16;
+	// the host's buffers are processed in chunks of BlockSize samples. larger chunks
+	// save per call overhead, smaller ones keep the buffers in cache (PPDBlockSize, 32 to 1024)
+	static constexpr int BlockSize = PPDBlockSize;
+	static_assert(BlockSize >= 32 && BlockSize <= 1024 && (BlockSize & (BlockSize - 1)) == 0,
+		"PPDBlockSize must be a power of 2 from 32 to 1024");
 	static constexpr int BlockSize2x = BlockSize * getOversamplingFactor(OversamplingOrder::x2);
 	static constexpr int BlockSize4x = BlockSize * getOversamplingFactor(OversamplingOrder::x4);
+	static constexpr int BlockSize8x = BlockSize * getOversamplingFactor(OversamplingOrder::x8);
+	static constexpr int BlockSize16x = BlockSize * getOversamplingFactor(OversamplingOrder::x16);
 
 	template<typename Float>
 	inline void copy(Float* dest, Float* src, int numSamples) noexcept
@@ -0,0 +1,208 @@
+#include "Crossover.h"
+
+namespace dsp
+{
+	template<typename Float, size_t MaxBands>
+	Crossover<Float, MaxBands>::Crossover() :
+		parallel(),
+		filters(),
+		coefs(),
+		frequencies(),
+		sampleRate(static_cast<Float>(1)),
+		numBands(1),
+		numBandsFrom(1),
+		fadePhase(static_cast<Float>(1)),
+		fadeInc(static_cast<Float>(1))
+	{
+		for (auto i = 0; i < MaxSplits; ++i)
+			frequencies[i] = static_cast<Float>(1000 * (i + 1));
+	}
+
+	template<typename Float, size_t MaxBands>
+	void Crossover<Float, MaxBands>::prepare(Float _sampleRate, int _numBands) noexcept
+	{
+		sampleRate = _sampleRate;
+		filters = Filters();
+		numBands = numBandsFrom = _numBands;
+		fadePhase = static_cast<Float>(1);
+		const auto fadeLength = CrossfadeMs * static_cast<Float>(.001) * sampleRate;
+		fadeInc = static_cast<Float>(1) / std::max(fadeLength, static_cast<Float>(1));
+		updateCoefs();
+	}
+
+	template<typename Float, size_t MaxBands>
+	void Crossover<Float, MaxBands>::setFrequencies(const Frequencies& _frequencies) noexcept
+	{
+		if (frequencies == _frequencies)
+			return;
+		frequencies = _frequencies;
+		updateCoefs();
+	}
+
+	template<typename Float, size_t MaxBands>
+	void Crossover<Float, MaxBands>::split(Float* const* samples, int numChannels, int numSamples, int _numBands) noexcept
+	{
+		setNumBands(_numBands);
+		dispatch<1, 1>(samples, numChannels, numSamples, std::min(numBands, numBandsFrom));
+		if (fadePhase >= static_cast<Float>(1))
+			numBandsFrom = numBands;
+	}
+
+	template<typename Float, size_t MaxBands>
+	void Crossover<Float, MaxBands>::join(Float* const* samples, int numChannels, int numSamples) noexcept
+	{
+		parallel.join(samples, numChannels, numSamples, getNumBands());
+	}
+
+	template<typename Float, size_t MaxBands>
+	int Crossover<Float, MaxBands>::getNumBands() const noexcept
+	{
+		return std::max(numBands, numBandsFrom);
+	}
+
+	template<typename Float, size_t MaxBands>
+	typename Crossover<Float, MaxBands>::Band Crossover<Float, MaxBands>::getBand(int bandIdx) noexcept
+	{
+		return parallel.getBand(bandIdx - 1);
+	}
+
+	template<typename Float, size_t MaxBands>
+	void Crossover<Float, MaxBands>::updateCoefs() noexcept
+	{
+		const auto nyquist = static_cast<Float>(.49) * sampleRate;
+		auto freqMin = static_cast<Float>(1);
+		for (auto i = 0; i < MaxSplits; ++i)
+		{
+			const auto freq = std::clamp(frequencies[i], std::min(freqMin, nyquist), nyquist);
+			freqMin = freq;
+			const auto g = std::tan(static_cast<Float>(Pi) * freq / sampleRate);
+			const auto k = SVF<Vec>::K;
+			const auto one = static_cast<Float>(1);
+			const auto a1 = one / (one + g * (g + k));
+			const auto a2 = g * a1;
+			const auto a3 = g * a2;
+			// bp = a1 ic1 - a2 ic2 + a2 x, lp = a2 ic1 + (1 - a3) ic2 + a3 x,
+			// hp = x - k bp - lp, ap = x - 2k bp, ic1 = 2 bp - ic1, ic2 = 2 lp - ic2
+			using Row = std::array<Float, 3>;
+			const Row ic1 = { a1 * 2 - one, -a2 * 2, a2 * 2 };
+			const Row ic2 = { a2 * 2, one - a3 * 2, a3 * 2 };
+			const Row lp = { a2, one - a3, a3 };
+			const Row hp = { -k * a1 - a2, k * a2 + a3 - one, one - k * a2 - a3 };
+			const Row ap = { -2 * k * a1, 2 * k * a2, one - 2 * k * a2 };
+			const auto mix = [](const Row& row)
+			{
+				return typename SVF<Vec>::Mix{ Vec::fill(row[0]), Vec::fill(row[1]), Vec::fill(row[2]) };
+			};
+			const auto mix2 = [](const Row& lo, const Row& hi)
+			{
+				return typename SVF<Vec2x2>::Mix{ Vec2x2::fill(lo[0], hi[0]), Vec2x2::fill(lo[1], hi[1]), Vec2x2::fill(lo[2], hi[2]) };
+			};
+			auto& c = coefs[i];
+			c.update = { mix(ic1), mix(ic2) };
+			c.lp = mix(lp);
+			c.hp = mix(hp);
+			c.ap = mix(ap);
+			c.update2 = { mix2(ic1, ic1), mix2(ic2, ic2) };
+			c.lowHigh = mix2(lp, hp);
+			c.ap2 = mix2(ap, ap);
+		}
+	}
+
+	template<typename Float, size_t MaxBands>
+	void Crossover<Float, MaxBands>::setNumBands(int _numBands) noexcept
+	{
+		if (_numBands == numBands || numBandsFrom != numBands)
+			return;
+		numBandsFrom = numBands;
+		numBands = _numBands;
+		fadePhase = static_cast<Float>(0);
+		// the splits above the old ones and their allpasses weren't running
+		for (auto s = numBandsFrom - 1; s < numBands - 1; ++s)
+		{
+			filters.input[s] = SVF<Vec>();
+			filters.lowHigh[s] = SVF<Vec2x2>();
+			if (s != 0)
+				filters.allpass[s - 1] = SVF<Vec>();
+			for (auto& pair : filters.allpassPairs)
+				pair[s] = SVF<Vec2x2>();
+		}
+	}
+
+	template<typename Float, size_t MaxBands>
+	template<int NumBands, int FadeBands>
+	void Crossover<Float, MaxBands>::dispatch(Float* const* samples, int numChannels, int numSamples,
+		int numBandsFade) noexcept
+	{
+		if constexpr (NumBands <= MaxBands)
+		{
+			if constexpr (FadeBands <= NumBands)
+			{
+				if (getNumBands() == NumBands && numBandsFade == FadeBands)
+					return process<NumBands, FadeBands>(samples, numChannels, numSamples);
+				dispatch<NumBands, FadeBands + 1>(samples, numChannels, numSamples, numBandsFade);
+			}
+			else
+				dispatch<NumBands + 1, 1>(samples, numChannels, numSamples, numBandsFade);
+		}
+	}
+
+	template<typename Float, size_t MaxBands>
+	template<int NumBands, int FadeBands>
+	void Crossover<Float, MaxBands>::process(Float* const* samples, int numChannels, int numSamples) noexcept
+	{
+		static constexpr bool Fading = FadeBands < NumBands;
+		// the coefs are only read, reloading them costs less than a copy of both layouts
+		const auto& c = coefs;
+		auto f = filters;
+
+		std::array<Float*, NumBands> l, r;
+		l[0] = samples[0];
+		r[0] = samples[numChannels - 1];
+		for (auto b = 1; b < NumBands; ++b)
+		{
+			const auto band = getBand(b);
+			l[b] = band[0];
+			r[b] = band[numChannels - 1];
+		}
+
+		// the weight of NumBands' topology is offset + scale * phase
+		const auto one = Vec::fill(static_cast<Float>(1));
+		const auto growing = numBands == NumBands;
+		const auto offset = Vec::fill(static_cast<Float>(growing ? 0 : 1));
+		const auto scale = Vec::fill(static_cast<Float>(growing ? 1 : -1));
+		const auto inc = Vec::fill(fadeInc);
+		auto phase = Vec::fill(fadePhase);
+
+		for (auto s = 0; s < numSamples; ++s)
+		{
+			auto x = Vec::load(l[0] + s, r[0] + s);
+			std::array<Vec, NumBands> y, yFade;
+			processSplits<0, NumBands, FadeBands>(x, y, yFade, f, c);
+			processAllpasses<0, NumBands, FadeBands>(y, yFade, f, c);
+			if constexpr (Fading)
+			{
+				phase = min(phase + inc, one);
+				const auto w = offset + scale * phase;
+				for (auto b = 0; b < FadeBands; ++b)
+					y[b] = yFade[b] + (y[b] - yFade[b]) * w;
+				for (auto b = FadeBands; b < NumBands; ++b)
+					y[b] = y[b] * w;
+			}
+			for (auto b = 0; b < NumBands; ++b)
+				y[b].store(l[b] + s, r[b] + s);
+		}
+
+		filters = f;
+		if constexpr (Fading)
+			fadePhase = phase.getL();
+	}
+
+	template struct Crossover<float, 2>;
+	template struct Crossover<double, 2>;
+	template struct Crossover<float, 3>;
+	template struct Crossover<double, 3>;
+	template struct Crossover<float, 4>;
+	template struct Crossover<double, 4>;
+	template struct Crossover<float, 5>;
+	template struct Crossover<double, 5>;
+}
\ No newline at end of file
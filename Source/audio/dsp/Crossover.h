@@ -0,0 +1,221 @@
+#pragma once
+#include "ParallelProcessor.h"
+#include "Vec2.h"
+
+namespace dsp
+{
+	/* linkwitz-riley crossover (LR4, 24db/oct) of a stereo pair into up to MaxBands bands.
+	band 0, the lowest, stays in the samples, the ones above go to a ParallelProcessor's bands,
+	so that join sums them back. the bands below each split run through its allpass,
+	which lines up their phase with the bands above it, so that the sum is flat */
+	template<typename Float, size_t MaxBands>
+	struct Crossover
+	{
+		static constexpr int MaxSplits = MaxBands - 1;
+		// changes of the number of bands crossfade between the topologies
+		static constexpr Float CrossfadeMs = static_cast<Float>(20);
+		// the bands of one stereo pair
+		using Parallel = ParallelProcessor<Float, MaxBands, 2>;
+		using Frequencies = std::array<Float, MaxSplits>;
+		using Band = typename Parallel::Band;
+
+		Crossover();
+
+		/* sampleRate, the rate it runs at, numBands[1,MaxBands], the one it starts with */
+		void prepare(Float, int) noexcept;
+
+		/* frequencies, in hz of each split, the first numBands - 1 of them count.
+		each one is kept at or above the one before and below nyquist */
+		void setFrequencies(const Frequencies&) noexcept;
+
+		/* samples, numChannels[1,2], numSamples[0,BlockSize], numBands[1,MaxBands]
+		band 0 overwrites samples. changes of numBands crossfade each band from the old topology to the new one.
+		the filters that stay keep their state, the ones that join in start from silence.
+		a change while a crossfade runs waits for it to end */
+		void split(Float* const*, int, int, int) noexcept;
+
+		/* samples, numChannels, numSamples, adds the bands above band 0 into samples */
+		void join(Float* const*, int, int) noexcept;
+
+		/* the bands split puts out, the larger topology's while crossfading */
+		int getNumBands() const noexcept;
+
+		/* bandIdx[1,getNumBands()[, the channels of one of the bands above band 0 */
+		Band getBand(int) noexcept;
+
+	private:
+		using Vec = Vec2<Float>;
+		using Vec2x2 = dsp::Vec2x2<Float>;
+
+		/* topology preserving transform state variable filter, butterworth, in state space form.
+		the next state and each output are mixes of the state and x, with x added last,
+		so that a cascade of them only waits one multiply and one add per filter for its input.
+		V is a Vec of one stereo pair, or a Vec2x2 of two that share the cutoff */
+		template<typename V>
+		struct SVF
+		{
+			// 1 / q
+			static constexpr Float K = static_cast<Float>(1.4142135623730951);
+
+			/* of ic1, ic2 and x */
+			struct Mix
+			{
+				V ic1, ic2, x;
+			};
+
+			/* the next ic1 and ic2 */
+			struct Update
+			{
+				Mix ic1, ic2;
+			};
+
+			/* x, update, mix, returns the output of mix */
+			forcedinline V operator()(V x, const Update& u, const Mix& m) noexcept
+			{
+				const auto y = m.ic1 * ic1 + m.ic2 * ic2 + m.x * x;
+				update(x, u);
+				return y;
+			}
+
+			/* x, update, mixLP, mixHP, lp, hp */
+			forcedinline void operator()(V x, const Update& u, const Mix& mLP, const Mix& mHP, V& lp, V& hp) noexcept
+			{
+				lp = mLP.ic1 * ic1 + mLP.ic2 * ic2 + mLP.x * x;
+				hp = mHP.ic1 * ic1 + mHP.ic2 * ic2 + mHP.x * x;
+				update(x, u);
+			}
+
+			/* x, update */
+			forcedinline void update(V x, const Update& u) noexcept
+			{
+				const auto next = u.ic1.ic1 * ic1 + u.ic1.ic2 * ic2 + u.ic1.x * x;
+				ic2 = u.ic2.ic1 * ic1 + u.ic2.ic2 * ic2 + u.ic2.x * x;
+				ic1 = next;
+			}
+
+			V ic1, ic2;
+		};
+
+		/* of one split. float has 4 lanes in a __m128 and the stereo pair only fills 2,
+		so the filters of a split that don't depend on each other run side by side */
+		struct SplitCoefs
+		{
+			// of one stereo pair
+			typename SVF<Vec>::Update update;
+			typename SVF<Vec>::Mix lp, hp, ap;
+			// of two side by side, the lowpass in lo and the highpass in hi, the allpass in both
+			typename SVF<Vec2x2>::Update update2;
+			typename SVF<Vec2x2>::Mix lowHigh, ap2;
+		};
+
+		/* the filters of one stereo pair, copied into locals while a block runs,
+		so that stores to the samples can't alias them */
+		struct Filters
+		{
+			// of each split the svf of its input
+			std::array<SVF<Vec>, MaxSplits> input;
+			// of each split the ones that square its lowpass and its highpass into LR4
+			std::array<SVF<Vec2x2>, MaxSplits> lowHigh;
+			// [band], the allpass of each even band at the split above the next one up, which doesn't have it
+			std::array<SVF<Vec>, MaxSplits> allpass;
+			// [band / 2][split], of each even band and the next one up, side by side, the allpasses of the splits above both
+			std::array<std::array<SVF<Vec2x2>, MaxSplits>, MaxSplits / 2> allpassPairs;
+		};
+
+		using Coefs = std::array<SplitCoefs, MaxSplits>;
+
+		Parallel parallel;
+		Filters filters;
+		Coefs coefs;
+		Frequencies frequencies;
+		Float sampleRate;
+		// the crossfade runs from the topology of numBandsFrom to the one of numBands
+		int numBands, numBandsFrom;
+		Float fadePhase, fadeInc;
+
+		void updateCoefs() noexcept;
+
+		/* _numBands, starts a crossfade to it if it is new and none runs */
+		void setNumBands(int) noexcept;
+
+		/* samples, numChannels, numSamples, numBandsFade
+		calls process for the larger topology and numBandsFade */
+		template<int NumBands, int FadeBands>
+		void dispatch(Float* const*, int, int, int) noexcept;
+
+		/* samples, numChannels, numSamples
+		the splits run one after the other on what is above the last one,
+		the allpasses of the bands below them don't depend on each other.
+		with FadeBands < NumBands it crossfades with the topology of FadeBands,
+		whose bands are on the way to the ones of NumBands */
+		template<int NumBands, int FadeBands>
+		void process(Float* const*, int, int) noexcept;
+
+		/* x, y, yFade, filters, coefs
+		splits x at Split into y[Split] and what is above, which the next split gets.
+		unrolls at compile time like SlewLimiter::processStages, the last band is what is left.
+		what is above the last split of FadeBands is its last band */
+		template<int Split, int NumBands, int FadeBands>
+		static forcedinline void processSplits(Vec x, std::array<Vec, NumBands>& y,
+			std::array<Vec, NumBands>& yFade, Filters& f, const Coefs& c) noexcept
+		{
+			if constexpr (FadeBands < NumBands && Split == FadeBands - 1)
+				yFade[Split] = x;
+			if constexpr (Split == NumBands - 1)
+				y[Split] = x;
+			else
+			{
+				// lowpass and highpass of LR4 are both butterworths squared, they sum to its allpass
+				const auto& cs = c[Split];
+				Vec lp, hp;
+				f.input[Split](x, cs.update, cs.lp, cs.hp, lp, hp);
+				const auto lowHigh = f.lowHigh[Split](Vec2x2::join(lp, hp), cs.update2, cs.lowHigh);
+				y[Split] = lowHigh.getLo();
+				x = lowHigh.getHi();
+				processSplits<Split + 1, NumBands, FadeBands>(x, y, yFade, f, c);
+			}
+		}
+
+		/* y, yFade, filters, coefs
+		runs y[Band] and y[Band + 1] through the allpass of each split above them, side by side where both have it.
+		the bands of FadeBands end before the allpass of the first split they don't have */
+		template<int Band, int NumBands, int FadeBands>
+		static forcedinline void processAllpasses(std::array<Vec, NumBands>& y,
+			std::array<Vec, NumBands>& yFade, Filters& f, const Coefs& c) noexcept
+		{
+			if constexpr (Band < NumBands - 2)
+			{
+				static constexpr int Split = Band + 1;
+				if constexpr (Split == FadeBands - 1)
+					yFade[Band] = y[Band];
+				y[Band] = f.allpass[Band](y[Band], c[Split].update, c[Split].ap);
+				if constexpr (Split + 1 < NumBands - 1)
+				{
+					auto pair = Vec2x2::join(y[Band], y[Band + 1]);
+					processAllpassPairs<Band, Split + 1, NumBands, FadeBands>(pair, yFade, f, c);
+					y[Band] = pair.getLo();
+					y[Band + 1] = pair.getHi();
+				}
+				processAllpasses<Band + 2, NumBands, FadeBands>(y, yFade, f, c);
+			}
+		}
+
+		/* pair, yFade, filters, coefs
+		runs pair, y[Band] and y[Band + 1], through the allpass of each split from Split on */
+		template<int Band, int Split, int NumBands, int FadeBands>
+		static forcedinline void processAllpassPairs(Vec2x2& pair,
+			std::array<Vec, NumBands>& yFade, Filters& f, const Coefs& c) noexcept
+		{
+			if constexpr (Split < NumBands - 1)
+			{
+				if constexpr (Split == FadeBands - 1)
+				{
+					yFade[Band] = pair.getLo();
+					yFade[Band + 1] = pair.getHi();
+				}
+				pair = f.allpassPairs[Band / 2][Split](pair, c[Split].update2, c[Split].ap2);
+				processAllpassPairs<Band, Split + 1, NumBands, FadeBands>(pair, yFade, f, c);
+			}
+		}
+	};
+}
\ No newline at end of file
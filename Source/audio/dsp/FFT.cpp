@@ -9,3 +9,97 @@
 */
 
 #include "FFT.h"
+
+
+namespace dsp
+{
+	template<typename Float>
+	FFTComplex<Float>::FFTComplex() :
+		twiddles(),
+		bitReversed(),
+		size(0)
+	{
+	}
+
+	template<typename Float>
+	void FFTComplex<Float>::prepare(int order)
+	{
+		size = 1 << order;
+		const auto sizeHalf = size / 2;
+
+		twiddles.resize(sizeHalf);
+		const auto sizeInv = 1. / static_cast<double>(size);
+		for (auto k = 0; k < sizeHalf; ++k)
+		{
+			const auto x = -Tau * static_cast<double>(k) * sizeInv;
+			twiddles[k] = Complex(static_cast<Float>(std::cos(x)), static_cast<Float>(std::sin(x)));
+		}
+
+		bitReversed.resize(size);
+		for (auto i = 0; i < size; ++i)
+		{
+			auto r = 0;
+			for (auto b = 0; b < order; ++b)
+				r |= ((i >> b) & 1) << (order - 1 - b);
+			bitReversed[i] = r;
+		}
+	}
+
+	template<typename Float>
+	void FFTComplex<Float>::forward(Complex* data) const noexcept
+	{
+		perform<false>(data);
+	}
+
+	template<typename Float>
+	void FFTComplex<Float>::inverse(Complex* data) const noexcept
+	{
+		perform<true>(data);
+	}
+
+	template<typename Float>
+	int FFTComplex<Float>::getSize() const noexcept
+	{
+		return size;
+	}
+
+	template<typename Float>
+	template<bool Inverse>
+	void FFTComplex<Float>::perform(Complex* data) const noexcept
+	{
+		for (auto i = 0; i < size; ++i)
+		{
+			const auto r = bitReversed[i];
+			if (i < r)
+				std::swap(data[i], data[r]);
+		}
+
+		// complex products are written out, because std::complex's
+		// operator* has to handle infs and nans and doesn't inline
+		for (auto len = 2; len <= size; len <<= 1)
+		{
+			const auto half = len / 2;
+			const auto step = size / len;
+			for (auto i = 0; i < size; i += len)
+			{
+				auto a = &data[i];
+				auto b = &data[i + half];
+				for (auto j = 0; j < half; ++j)
+				{
+					const auto w = twiddles[j * step];
+					const auto wRe = w.real();
+					const auto wIm = Inverse ? -w.imag() : w.imag();
+					const auto bRe = b[j].real() * wRe - b[j].imag() * wIm;
+					const auto bIm = b[j].real() * wIm + b[j].imag() * wRe;
+					const auto aRe = a[j].real();
+					const auto aIm = a[j].imag();
+					a[j] = Complex(aRe + bRe, aIm + bIm);
+					b[j] = Complex(aRe - bRe, aIm - bIm);
+				}
+			}
+		}
+	}
+
+	template struct FFTComplex<float>;
+	template struct FFTComplex<double>;
+}
\ No newline at end of file
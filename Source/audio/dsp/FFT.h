@@ -1,10 +1,41 @@
 #pragma once
 #include "juce_dsp/juce_dsp.h"
-//#include <complex>
+#include <complex>
+#include <vector>
 #include "../Using.h"
 
 namespace dsp
 {
+	/* in-place iterative radix-2 fft of complex data.
+	two real signals can be transformed at once by
+	putting one into the real and the other into the imaginary part */
+	template<typename Float>
+	struct FFTComplex
+	{
+		using Complex = std::complex<Float>;
+
+		FFTComplex();
+
+		/* order, allocates the tables */
+		void prepare(int);
+
+		/* data */
+		void forward(Complex*) const noexcept;
+
+		/* data, not normalized */
+		void inverse(Complex*) const noexcept;
+
+		int getSize() const noexcept;
+
+	private:
+		std::vector<Complex> twiddles;
+		std::vector<int> bitReversed;
+		int size;
+
+		template<bool Inverse>
+		void perform(Complex*) const noexcept;
+	};
+
 	struct FFT
 	{
 		static constexpr int Order = 9;
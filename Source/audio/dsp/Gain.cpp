@@ -3,20 +3,20 @@
 
 namespace dsp
 {
-	template<double SmoothLengthMs>
-	Gain<SmoothLengthMs>::Gain(double defaultValueDb) :
+	template<typename Float, double SmoothLengthMs>
+	Gain<Float, SmoothLengthMs>::Gain(Float defaultValueDb) :
 		gainPRM(math::decibelToAmp(defaultValueDb)),
-		gainInfo(nullptr, 0., false)
+		gainInfo(nullptr, static_cast<Float>(0), false)
 	{}
 
-	template<double SmoothLengthMs>
-	void Gain<SmoothLengthMs>::prepare(double sampleRate) noexcept
+	template<typename Float, double SmoothLengthMs>
+	void Gain<Float, SmoothLengthMs>::prepare(double sampleRate) noexcept
 	{
-		gainPRM.prepare(sampleRate, SmoothLengthMs);
+		gainPRM.prepare(static_cast<Float>(sampleRate), static_cast<Float>(SmoothLengthMs));
 	}
 
-	template<double SmoothLengthMs>
-	void Gain<SmoothLengthMs>::operator()(double* const* samples, double gainDb,
+	template<typename Float, double SmoothLengthMs>
+	void Gain<Float, SmoothLengthMs>::operator()(Float* const* samples, Float gainDb,
 		int numChannels, int numSamples) noexcept
 	{
 		const auto gainAmp = math::decibelToAmp(gainDb);
@@ -36,8 +36,8 @@ namespace dsp
 			}
 	}
 
-	template<double SmoothLengthMs>
-	void Gain<SmoothLengthMs>::applyInverse(double* const* samples, int numChannels, int numSamples) noexcept
+	template<typename Float, double SmoothLengthMs>
+	void Gain<Float, SmoothLengthMs>::applyInverse(Float* const* samples, int numChannels, int numSamples) noexcept
 	{
 		if (gainInfo.smoothing)
 			for (auto ch = 0; ch < numChannels; ++ch)
@@ -48,7 +48,7 @@ namespace dsp
 			}
 		else
 		{
-			gainInfo.val = 1. / gainInfo.val;
+			gainInfo.val = static_cast<Float>(1) / gainInfo.val;
 
 			for (auto ch = 0; ch < numChannels; ++ch)
 			{
@@ -58,28 +58,45 @@ namespace dsp
 		}
 	}
 
-	template<double SmoothLengthMs>
-	void Gain<SmoothLengthMs>::applyInverse(double* smpls, int numSamples) noexcept
+	template<typename Float, double SmoothLengthMs>
+	void Gain<Float, SmoothLengthMs>::applyInverse(Float* smpls, int numSamples) noexcept
 	{
 		if (gainInfo.smoothing)
 			for (auto s = 0; s < numSamples; ++s)
 				smpls[s] /= gainInfo.buf[s];
 		else
 		{
-			gainInfo.val = 1. / gainInfo.val;
+			gainInfo.val = static_cast<Float>(1) / gainInfo.val;
 			SIMD::multiply(smpls, gainInfo.val, numSamples);
 		}
 	}
 
-	template struct Gain<1.>;
-	template struct Gain<2.>;
-	template struct Gain<3.>;
-	template struct Gain<5.>;
-	template struct Gain<8.>;
-	template struct Gain<13.>;
-	template struct Gain<21.>;
-	template struct Gain<34.>;
-	template struct Gain<55.>;
-	template struct Gain<89.>;
-	template struct Gain<144.>;
+	template<typename Float, double SmoothLengthMs>
+	bool Gain<Float, SmoothLengthMs>::isSmoothing() const noexcept
+	{
+		return gainInfo.smoothing;
+	}
+
+	template struct Gain<float, 1.>;
+	template struct Gain<double, 1.>;
+	template struct Gain<float, 2.>;
+	template struct Gain<double, 2.>;
+	template struct Gain<float, 3.>;
+	template struct Gain<double, 3.>;
+	template struct Gain<float, 5.>;
+	template struct Gain<double, 5.>;
+	template struct Gain<float, 8.>;
+	template struct Gain<double, 8.>;
+	template struct Gain<float, 13.>;
+	template struct Gain<double, 13.>;
+	template struct Gain<float, 21.>;
+	template struct Gain<double, 21.>;
+	template struct Gain<float, 34.>;
+	template struct Gain<double, 34.>;
+	template struct Gain<float, 55.>;
+	template struct Gain<double, 55.>;
+	template struct Gain<float, 89.>;
+	template struct Gain<double, 89.>;
+	template struct Gain<float, 144.>;
+	template struct Gain<double, 144.>;
 }
\ No newline at end of file
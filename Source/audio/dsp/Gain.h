@@ -3,26 +3,29 @@
 
 namespace dsp
 {
-	template<double SmoothLengthMs>
+	template<typename Float, double SmoothLengthMs>
 	struct Gain
 	{
 		/* defaultValueDb */
-		Gain(double);
+		Gain(Float);
 
 		/* sampleRate */
 		void prepare(double) noexcept;
 
 		/* samples, gainDb, numChannels, numSamples */
-		void operator()(double* const*, double, int, int) noexcept;
+		void operator()(Float* const*, Float, int, int) noexcept;
 
 		/* samples, numChannels, numSamples */
-		void applyInverse(double* const*, int, int) noexcept;
+		void applyInverse(Float* const*, int, int) noexcept;
 
 		/* smpls, numSamples */
-		void applyInverse(double*, int) noexcept;
+		void applyInverse(Float*, int) noexcept;
+
+		/* true if the last block was still gliding towards the gain */
+		bool isSmoothing() const noexcept;
 
 	private:
-		PRMD gainPRM;
-		PRMInfoD gainInfo;
+		PRM<Float> gainPRM;
+		PRMInfo<Float> gainInfo;
 	};
 }
\ No newline at end of file
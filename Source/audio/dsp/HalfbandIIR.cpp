@@ -0,0 +1,230 @@
+#include "HalfbandIIR.h"
+
+namespace dsp
+{
+	// elliptic half-band design after Valenzuela & Constantinides,
+	// the same closed form as in Laurent de Soras' hiir
+	namespace halfband
+	{
+		/* k, q, transition */
+		inline void getTransitionParams(double& k, double& q, double transition)
+		{
+			k = std::tan((1. - transition * 2.) * Pi * .25);
+			k *= k;
+			const auto kkSqrt = std::pow(1. - k * k, .25);
+			const auto e = .5 * (1. - kkSqrt) / (1. + kkSqrt);
+			const auto e2 = e * e;
+			const auto e4 = e2 * e2;
+			q = e * (1. + e4 * (2. + e4 * (15. + 150. * e4)));
+		}
+
+		/* attenuationDb, q */
+		inline int getOrder(double attenuation, double q)
+		{
+			const auto attnP2 = std::pow(10., -attenuation * .1);
+			const auto a = attnP2 / (1. - attnP2);
+			auto order = static_cast<int>(std::ceil(std::log(a * a / 16.) / std::log(q)));
+			if ((order & 1) == 0)
+				++order;
+			if (order == 1)
+				order = 3;
+			return order;
+		}
+
+		/* q, order, c */
+		inline double getAccNum(double q, int order, int c)
+		{
+			auto acc = 0.;
+			auto sign = 1.;
+			auto i = 0.;
+			auto term = 0.;
+			do
+			{
+				term = std::pow(q, i * (i + 1.)) * std::sin((i * 2. + 1.) * c * Pi / order) * sign;
+				acc += term;
+				sign = -sign;
+				++i;
+			} while (std::abs(term) > 1e-100);
+			return acc;
+		}
+
+		/* q, order, c */
+		inline double getAccDen(double q, int order, int c)
+		{
+			auto acc = 0.;
+			auto sign = -1.;
+			auto i = 1.;
+			auto term = 0.;
+			do
+			{
+				term = std::pow(q, i * i) * std::cos(i * 2. * c * Pi / order) * sign;
+				acc += term;
+				sign = -sign;
+				++i;
+			} while (std::abs(term) > 1e-100);
+			return acc;
+		}
+
+		/* idx, k, q, order */
+		inline double getCoef(int idx, double k, double q, int order)
+		{
+			const auto c = idx + 1;
+			const auto num = getAccNum(q, order, c) * std::pow(q, .25);
+			const auto den = getAccDen(q, order, c) + .5;
+			const auto ww = num / den;
+			const auto wwSq = ww * ww;
+			const auto x = std::sqrt((1. - wwSq * k) * (1. - wwSq / k)) / (1. + wwSq);
+			return (1. - x) / (1. + x);
+		}
+	}
+
+	template<typename Float>
+	int HalfbandIIR<Float>::design(Coefs& coefs, double attenuation, double transition)
+	{
+		double k, q;
+		halfband::getTransitionParams(k, q, transition);
+		// the order is capped, which costs attenuation
+		const auto order = std::min(halfband::getOrder(attenuation, q), MaxCoefs * 2 + 1);
+		const auto numCoefs = (order - 1) / 2;
+		for (auto i = 0; i < numCoefs; ++i)
+			coefs[i] = halfband::getCoef(i, k, q, order);
+		return numCoefs;
+	}
+
+	template<typename Float>
+	double HalfbandIIR<Float>::getAttenuation(int numCoefs, double transition)
+	{
+		double k, q;
+		halfband::getTransitionParams(k, q, transition);
+		const auto order = numCoefs * 2 + 1;
+		const auto a = 4. * std::exp(order * .5 * std::log(q));
+		return -10. * std::log10(a / (1. + a));
+	}
+
+	template<typename Float>
+	HalfbandIIR<Float>::HalfbandIIR() :
+		coefs(),
+		allpassesUp(),
+		allpassesDown(),
+		numCoefs(0),
+		latency(0.)
+	{
+	}
+
+	template<typename Float>
+	void HalfbandIIR<Float>::prepare(double attenuation, double transition)
+	{
+		Coefs designCoefs;
+		numCoefs = design(designCoefs, attenuation, transition);
+
+		// an allpass (a + z^-1) / (1 + a * z^-1) delays dc by (1 - a) / (1 + a).
+		// both chains add up to the delay of up- and downsampling at the lower rate
+		latency = 0.;
+		for (auto i = 0; i < numCoefs; ++i)
+		{
+			const auto a = designCoefs[i];
+			coefs[i] = Vec::fill(static_cast<Float>(a));
+			latency += (1. - a) / (1. + a);
+		}
+		latency *= 2.;
+
+		const auto zero = Vec::fill(static_cast<Float>(0));
+		for (auto allpasses : { &allpassesUp, &allpassesDown })
+		{
+			allpasses->x.fill(zero);
+			allpasses->y.fill(zero);
+		}
+	}
+
+	template<typename Float>
+	void HalfbandIIR<Float>::upsample(Float* const* samplesUp, const Float* const* samplesIn,
+		int numChannels, int numSamplesIn) noexcept
+	{
+		const auto inL = samplesIn[0];
+		const auto inR = samplesIn[numChannels - 1];
+		auto upL = samplesUp[0];
+		auto upR = samplesUp[numChannels - 1];
+
+		for (auto s = 0; s < numSamplesIn; ++s)
+		{
+			Vec a, b;
+			upsample(Vec::load(&inL[s], &inR[s]), a, b);
+
+			const auto s2 = s * 2;
+			a.store(&upL[s2], &upR[s2]);
+			b.store(&upL[s2 + 1], &upR[s2 + 1]);
+		}
+	}
+
+	template<typename Float>
+	void HalfbandIIR<Float>::downsample(Float* const* samplesOut, const Float* const* samplesUp,
+		int numChannels, int numSamplesOut) noexcept
+	{
+		const auto upL = samplesUp[0];
+		const auto upR = samplesUp[numChannels - 1];
+		auto outL = samplesOut[0];
+		auto outR = samplesOut[numChannels - 1];
+
+		for (auto s = 0; s < numSamplesOut; ++s)
+		{
+			const auto s2 = s * 2;
+			const auto y = downsample(Vec::load(&upL[s2], &upR[s2]), Vec::load(&upL[s2 + 1], &upR[s2 + 1]));
+			y.store(&outL[s], &outR[s]);
+		}
+	}
+
+	template<typename Float>
+	void HalfbandIIR<Float>::upsample(Vec x, Vec& y0, Vec& y1) noexcept
+	{
+		y0 = x;
+		y1 = x;
+		process(y0, y1, allpassesUp);
+	}
+
+	template<typename Float>
+	typename HalfbandIIR<Float>::Vec HalfbandIIR<Float>::downsample(Vec x0, Vec x1) noexcept
+	{
+		auto a = x1;
+		auto b = x0;
+		process(a, b, allpassesDown);
+		return (a + b) * Vec::fill(static_cast<Float>(.5));
+	}
+
+	template<typename Float>
+	double HalfbandIIR<Float>::getLatency() const noexcept
+	{
+		return latency;
+	}
+
+	template<typename Float>
+	int HalfbandIIR<Float>::getNumCoefs() const noexcept
+	{
+		return numCoefs;
+	}
+
+	template<typename Float>
+	void HalfbandIIR<Float>::process(Vec& a, Vec& b, Allpasses& allpasses) noexcept
+	{
+		auto& x = allpasses.x;
+		auto& y = allpasses.y;
+
+		for (auto i = 0; i < numCoefs; i += 2)
+		{
+			const auto out = (a - y[i]) * coefs[i] + x[i];
+			x[i] = a;
+			y[i] = out;
+			a = out;
+		}
+
+		for (auto i = 1; i < numCoefs; i += 2)
+		{
+			const auto out = (b - y[i]) * coefs[i] + x[i];
+			x[i] = b;
+			y[i] = out;
+			b = out;
+		}
+	}
+
+	template struct HalfbandIIR<float>;
+	template struct HalfbandIIR<double>;
+}
\ No newline at end of file
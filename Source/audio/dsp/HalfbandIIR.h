@@ -0,0 +1,62 @@
+#pragma once
+#include "Vec2.h"
+
+namespace dsp
+{
+	/* 2x half-band lowpass of two parallel chains of first order allpasses,
+	which run at the lower rate (polyphase iir, elliptic response).
+	a handful of coefficients replaces a long fir, but the phase isn't linear */
+	template<typename Float>
+	struct HalfbandIIR
+	{
+		static constexpr int MaxCoefs = 16;
+		using Coefs = std::array<double, MaxCoefs>;
+
+		/* coefs, attenuationDb, transition
+		transition is the width of the transition band relative to the upsampled rate.
+		it is centered on a quarter of it. returns the number of coefficients */
+		static int design(Coefs&, double, double);
+
+		/* numCoefs, transition, returns the stopband attenuation in db */
+		static double getAttenuation(int, double);
+
+		HalfbandIIR();
+
+		/* attenuationDb, transition */
+		void prepare(double, double);
+
+		/* samplesUp, samplesIn, numChannels, numSamplesIn */
+		void upsample(Float* const*, const Float* const*, int, int) noexcept;
+
+		/* samplesOut, samplesUp, numChannels, numSamplesOut */
+		void downsample(Float* const*, const Float* const*, int, int) noexcept;
+
+		/* x, y0, y1, upsamples one sample */
+		void upsample(Vec2<Float>, Vec2<Float>&, Vec2<Float>&) noexcept;
+
+		/* x0, x1, downsamples one pair of samples */
+		Vec2<Float> downsample(Vec2<Float>, Vec2<Float>) noexcept;
+
+		/* group delay of up- and downsampling at dc, in samples of the upsampled rate */
+		double getLatency() const noexcept;
+
+		int getNumCoefs() const noexcept;
+
+	private:
+		using Vec = Vec2<Float>;
+
+		struct Allpasses
+		{
+			std::array<Vec, MaxCoefs> x, y;
+		};
+
+		std::array<Vec, MaxCoefs> coefs;
+		Allpasses allpassesUp, allpassesDown;
+		int numCoefs;
+		double latency;
+
+		/* a, b, allpasses
+		a runs through the even coefficients, b through the odd ones */
+		void process(Vec&, Vec&, Allpasses&) noexcept;
+	};
+}
\ No newline at end of file
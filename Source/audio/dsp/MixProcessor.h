@@ -5,9 +5,10 @@
 
 namespace dsp
 {	
+	template<typename Float>
 	struct LatencyCompensation
 	{
-		using DryBuffers = std::array<std::array<double, BlockSize>, 2>;
+		using DryBuffers = std::array<std::array<Float, BlockSize>, MaxChannels>;
 
 		LatencyCompensation() :
 			ring(),
@@ -20,7 +21,7 @@ namespace dsp
 			latency = _latency;
 			if (latency != 0)
 			{
-				ring.setSize(2, latency, false, true, false);
+				ring.setSize(MaxChannels, latency, false, true, false);
 				wHead.prepare(latency);
 			}
 			else
@@ -30,7 +31,7 @@ namespace dsp
 			}
 		}
 
-		void operator()(DryBuffers& dryBuffers, const double* const* inputSamples,
+		void operator()(DryBuffers& dryBuffers, const Float* const* inputSamples,
 			int numChannels, int numSamples) noexcept
 		{
 			if (latency != 0)
@@ -59,7 +60,7 @@ namespace dsp
 					SIMD::copy(dryBuffers[ch].data(), inputSamples[ch], numSamples);
 		}
 
-		void operator()(double* const* samples, int numChannels, int numSamples) noexcept
+		void operator()(Float* const* samples, int numChannels, int numSamples) noexcept
 		{
 			if (latency != 0)
 			{
@@ -83,16 +84,17 @@ namespace dsp
 		}
 
 	protected:
-		AudioBuffer ring;
+		AudioBuffer<Float> ring;
 		WHead1x wHead;
 	public:
 		int latency;
 	};
 
+	template<typename Float>
 	struct MixProcessorNonlinear
 	{
 		MixProcessorNonlinear() :
-			gainIn(0.)
+			gainIn(static_cast<Float>(0))
 		{}
 
 		void prepare(double sampleRate)
@@ -100,13 +102,13 @@ namespace dsp
 			gainIn.prepare(sampleRate);
 		}
 
-		void split(double* const* samples, double gainInDb,
+		void split(Float* const* samples, Float gainInDb,
 			int numChannels, int numSamples) noexcept
 		{
 			gainIn(samples, gainInDb, numChannels, numSamples);
 		}
 
-		void join(double* const* samples,
+		void join(Float* const* samples,
 			int numChannels, int numSamples,
 			bool unityGain) noexcept
 		{
@@ -114,16 +116,17 @@ namespace dsp
 				gainIn.applyInverse(samples, numChannels, numSamples);
 		}
 
-		Gain<13.> gainIn;
+		Gain<Float, 13.> gainIn;
 	};
 
+	template<typename Float>
 	struct MixProcessorDryWet
 	{
 		MixProcessorDryWet() :
 			parallelProcessor(),
-			gainDry(0.f),
-			gainWetIn(0.f),
-			gainWetOut(0.f)
+			gainDry(static_cast<Float>(0)),
+			gainWetIn(static_cast<Float>(0)),
+			gainWetOut(static_cast<Float>(0))
 		{}
 
 		void prepare(double sampleRate)
@@ -134,17 +137,16 @@ namespace dsp
 		}
 
 		/* samples, gainDryDb, numChannels, numSamples */
-		void splitLinear(double* const* samples, double gainDryDb,
+		void splitLinear(Float* const* samples, Float gainDryDb,
 			int numChannels, int numSamples) noexcept
 		{
 			parallelProcessor.split(samples, numChannels, numSamples);
 			const auto band = parallelProcessor.getBand(0);
-			double* bandBuf[] = { band.l, band.r };
-			gainDry(bandBuf, gainDryDb, numChannels, numSamples);
+			gainDry(band.data(), gainDryDb, numChannels, numSamples);
 		}
 
 		/* samples, gainDryDb, gainWetInDb, numChannels, numSamples */
-		void splitNonlinear(double* const* samples, double gainDryDb, double gainWetInDb,
+		void splitNonlinear(Float* const* samples, Float gainDryDb, Float gainWetInDb,
 			int numChannels, int numSamples) noexcept
 		{
 			splitLinear(samples, gainDryDb, numChannels, numSamples);
@@ -152,7 +154,7 @@ namespace dsp
 		}
 
 		/* samples, gainWetDb, numChannels, numSamples  */
-		void joinLinear(double* const* samples, double gainWetOutDb,
+		void joinLinear(Float* const* samples, Float gainWetOutDb,
 			int numChannels, int numSamples) noexcept
 		{
 			gainWetOut(samples, gainWetOutDb, numChannels, numSamples);
@@ -160,7 +162,7 @@ namespace dsp
 		}
 
 		/* samples, gainWetDb, numChannels, numSamples, unityGain  */
-		void joinNonlinear(double* const* samples, double gainWetOutDb,
+		void joinNonlinear(Float* const* samples, Float gainWetOutDb,
 			int numChannels, int numSamples, bool unityGain) noexcept
 		{
 			if(unityGain)
@@ -169,35 +171,36 @@ namespace dsp
 		}
 
 	private:
-		PP2Band parallelProcessor;
-		Gain<13.> gainDry, gainWetIn, gainWetOut;
+		PP2Band<Float> parallelProcessor;
+		Gain<Float, 13.> gainDry, gainWetIn, gainWetOut;
 	};
 
+	template<typename Float>
 	struct MixProcessorWetMix
 	{
 		MixProcessorWetMix() :
 			parallelProcessor(),
-			gainWetIn(0.f),
-			gainWetOut(0.f),
-			mixPRM(1.f)
+			gainWetIn(static_cast<Float>(0)),
+			gainWetOut(static_cast<Float>(0)),
+			mixPRM(static_cast<Float>(1))
 		{}
 
 		void prepare(double sampleRate)
 		{
 			gainWetIn.prepare(sampleRate);
 			gainWetOut.prepare(sampleRate);
-			mixPRM.prepare(sampleRate, 13.);
+			mixPRM.prepare(static_cast<Float>(sampleRate), static_cast<Float>(13));
 		}
 
 		/* samples, numChannels, numSamples */
-		void splitLinear(double* const* samples,
+		void splitLinear(Float* const* samples,
 			int numChannels, int numSamples) noexcept
 		{
 			parallelProcessor.split(samples, numChannels, numSamples);
 		}
 
 		/* samples, gainWetInDb, numChannels, numSamples */
-		void splitNonlinear(double* const* samples, double gainWetInDb,
+		void splitNonlinear(Float* const* samples, Float gainWetInDb,
 			int numChannels, int numSamples) noexcept
 		{
 			splitLinear(samples, numChannels, numSamples);
@@ -205,7 +208,7 @@ namespace dsp
 		}
 
 		/* samples, mix, gainWetOutDb, numChannels, numSamples, delta  */
-		void joinLinear(double* const* samples, double mix, double gainWetOutDb,
+		void joinLinear(Float* const* samples, Float mix, Float gainWetOutDb,
 			int numChannels, int numSamples, bool delta) noexcept
 		{
 			gainWetOut(samples, gainWetOutDb, numChannels, numSamples);
@@ -216,7 +219,7 @@ namespace dsp
 		}
 
 		/* samples, mix, gainWetOutDb, numChannels, numSamples, unityGain, delta  */
-		void joinNonlinear(double* const* samples, double mix, double gainWetOutDb,
+		void joinNonlinear(Float* const* samples, Float mix, Float gainWetOutDb,
 			int numChannels, int numSamples, bool unityGain, bool delta) noexcept
 		{
 			if (unityGain)
@@ -225,12 +228,12 @@ namespace dsp
 		};
 	
 	private:
-		PP2Band parallelProcessor;
-		Gain<13.> gainWetIn, gainWetOut;
-		PRMD mixPRM;
+		PP2Band<Float> parallelProcessor;
+		Gain<Float, 13.> gainWetIn, gainWetOut;
+		PRM<Float> mixPRM;
 
 		/* samples, mix, numChannels, numSamples */
-		void joinMix(double* const* samples, double mix, int numChannels, int numSamples) noexcept
+		void joinMix(Float* const* samples, Float mix, int numChannels, int numSamples) noexcept
 		{
 			const auto mixInfo = mixPRM(mix, numSamples);
 			if (mixInfo.smoothing)
@@ -240,7 +243,7 @@ namespace dsp
 		}
 
 		/* samples, mix, numChannels, numSamples */
-		void joinDelta(double* const* samples, double mix, int numChannels, int numSamples) noexcept
+		void joinDelta(Float* const* samples, Float mix, int numChannels, int numSamples) noexcept
 		{
 			const auto mixInfo = mixPRM(mix, numSamples);
 			if (mixInfo.smoothing)
@@ -250,11 +253,12 @@ namespace dsp
 		}
 	};
 
+	template<typename Float>
 	struct MixProcessor
 	{
 		MixProcessor() :
 			mixProcessor(),
-			gainOut(0.)
+			gainOut(static_cast<Float>(0))
 		{}
 
 		void prepare(double sampleRate)
@@ -263,23 +267,29 @@ namespace dsp
 			gainOut.prepare(sampleRate);
 		}
 
+		/* true if the output gain was still gliding in the last block */
+		bool isSmoothing() const noexcept
+		{
+			return gainOut.isSmoothing();
+		}
+
 #if PPDIO == PPDIOOut
 	#if PPDIsNonlinear
 		/* samples, gainInDb, numChannels, numSamples */
-		void split(double* const* samples, double gainInDb,
+		void split(Float* const* samples, Float gainInDb,
 			int numChannels, int numSamples) noexcept
 		{
 			mixProcessor.split(samples, gainInDb, numChannels, numSamples);
 		}
 		/* samples, gainOutDb, numChannels, numSamples, unityGain */
-		void join(double* const* samples, double gainOutDb,
+		void join(Float* const* samples, Float gainOutDb,
 			int numChannels, int numSamples, bool unityGain) noexcept
 		{
 			mixProcessor.join(samples, numChannels, numSamples, unityGain);
 			gainOut(samples, gainOutDb, numChannels, numSamples);
 		}
 	#else
-		void join(double* const* samples, double gainOutDb,
+		void join(Float* const* samples, Float gainOutDb,
 			int numChannels, int numSamples) noexcept
 		{
 			gainOut(samples, gainOutDb, numChannels, numSamples);
@@ -288,14 +298,14 @@ namespace dsp
 #elif PPDIO == PPDIODryWet
 	#if PPDIsNonlinear
 		/* samples, gainDryDb, gainWetInDb, numChannels, numSamples */
-		void split(double* const* samples, double gainDryDb, double gainWetInDb,
+		void split(Float* const* samples, Float gainDryDb, Float gainWetInDb,
 			int numChannels, int numSamples) noexcept
 		{
 			mixProcessor.splitNonlinear(samples, gainDryDb, gainWetInDb, numChannels, numSamples);
 		}
 
 		/* samples, gainWetOutDb, gainOutDb, numChannels, numSamples, unityGain */
-		void join(double* const* samples, double gainWetOutDb, double gainOutDb,
+		void join(Float* const* samples, Float gainWetOutDb, Float gainOutDb,
 			int numChannels, int numSamples, bool unityGain) noexcept
 		{
 			mixProcessor.joinNonlinear(samples, gainWetOutDb, numChannels, numSamples, unityGain);
@@ -303,14 +313,14 @@ namespace dsp
 		}
 	#else
 		/* samples, gainDryDb, numChannels, numSamples */
-		void split(double* const* samples, double gainDryDb,
+		void split(Float* const* samples, Float gainDryDb,
 			int numChannels, int numSamples) noexcept
 		{
 			mixProcessor.splitLinear(samples, gainDryDb, numChannels, numSamples);
 		}
 
 		/* samples, gainWetOutDb, gainOutDb, numChannels, numSamples */
-		void join(double* const* samples, double gainWetOutDb, double gainOutDb,
+		void join(Float* const* samples, Float gainWetOutDb, Float gainOutDb,
 			int numChannels, int numSamples) noexcept
 		{
 			mixProcessor.joinLinear(samples, gainWetOutDb, numChannels, numSamples);
@@ -320,14 +330,14 @@ namespace dsp
 #else
 	#if PPDIsNonlinear
 		/* samples, gainWetInDb, numChannels, numSamples */
-		void split(double* const* samples, double gainWetInDb,
+		void split(Float* const* samples, Float gainWetInDb,
 			int numChannels, int numSamples) noexcept
 		{
 			mixProcessor.splitNonlinear(samples, gainWetInDb, numChannels, numSamples);
 		}
 
 		/* samples, mix, gainWetDb, gainOutDb, numChannels, numSamples, unityGain, delta */
-		void join(double* const* samples, double mix, double gainWetDb, double gainOutDb,
+		void join(Float* const* samples, Float mix, Float gainWetDb, Float gainOutDb,
 			int numChannels, int numSamples, bool unityGain, bool delta) noexcept
 		{
 			mixProcessor.joinNonlinear(samples, mix, gainWetDb, numChannels, numSamples, unityGain, delta);
@@ -335,14 +345,14 @@ namespace dsp
 		}
 	#else
 		/* samples, numChannels, numSamples */
-		void split(double* const* samples,
+		void split(Float* const* samples,
 			int numChannels, int numSamples) noexcept
 		{
 			mixProcessor.splitLinear(samples, numChannels, numSamples);
 		}
 
 		/* samples, mix, gainWetDb, gainOutDb, numChannels, numSamples, delta */
-		void join(double* const* samples, double mix, double gainWetDb, double gainOutDb,
+		void join(Float* const* samples, Float mix, Float gainWetDb, Float gainOutDb,
 			int numChannels, int numSamples, bool delta) noexcept
 		{
 			mixProcessor.joinLinear(samples, mix, gainWetDb, numChannels, numSamples, delta);
@@ -353,12 +363,15 @@ namespace dsp
 
 	private:
 #if PPDIO == PPDIOOut
-		MixProcessorNonlinear mixProcessor;
+		MixProcessorNonlinear<Float> mixProcessor;
 #elif PPDIO == PPDIODryWet
-		MixProcessorDryWet mixProcessor;
+		MixProcessorDryWet<Float> mixProcessor;
 #else
-		MixProcessorWetMix mixProcessor;
+		MixProcessorWetMix<Float> mixProcessor;
 #endif
-		Gain<13.> gainOut;
+		Gain<Float, 13.> gainOut;
 	};
+
+	using MixProcessorF = MixProcessor<float>;
+	using MixProcessorD = MixProcessor<double>;
 }
\ No newline at end of file
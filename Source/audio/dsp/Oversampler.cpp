@@ -1,145 +1,565 @@
 #include "Oversampler.h"
+#include <tuple>
 
 namespace dsp
 {
-	ImpulseResponse::ImpulseResponse() :
+	// kaiser window design after Kaiser & Schafer, as in Oppenheim & Schafer's
+	// discrete-time signal processing
+	namespace kaiser
+	{
+		/* x, zeroth order modified bessel function of the first kind */
+		inline double besselI0(double x)
+		{
+			const auto xHalf = x * .5;
+			auto sum = 1.;
+			auto term = 1.;
+			for (auto k = 1; k < 128; ++k)
+			{
+				term *= xHalf / static_cast<double>(k);
+				const auto termSq = term * term;
+				sum += termSq;
+				if (termSq < sum * 1e-17)
+					break;
+			}
+			return sum;
+		}
+
+		/* attenuationDb */
+		inline double getBeta(double attenuation)
+		{
+			if (attenuation > 50.)
+				return .1102 * (attenuation - 8.7);
+			if (attenuation >= 21.)
+				return .5842 * std::pow(attenuation - 21., .4) + .07886 * (attenuation - 21.);
+			return 0.;
+		}
+
+		/* attenuationDb, transition in radians per sample, returns the estimated order */
+		inline int getOrder(double attenuation, double transition)
+		{
+			const auto order = (attenuation - 7.95) / (2.285 * transition);
+			return std::max(2, static_cast<int>(std::ceil(order)));
+		}
+
+		/* design, order, wPass, wStop, deltaPass, deltaStop
+		largest deviation of an even order symmetric filter from either band's target,
+		relative to the band's tolerance. the filter meets its targets if it's <= 1 */
+		inline double getError(const double* design, int order, double wPass, double wStop,
+			double deltaPass, double deltaStop)
+		{
+			const auto half = order / 2;
+			const auto amplitude = [&](double w)
+			{
+				// cos(kw) by its recurrence, cos((k + 1)w) = 2cos(w)cos(kw) - cos((k - 1)w)
+				const auto cos1 = std::cos(w);
+				auto cosPrev = 1.;
+				auto cosK = cos1;
+				auto a = design[half];
+				for (auto k = 1; k <= half; ++k)
+				{
+					a += 2. * design[half - k] * cosK;
+					const auto cosNext = 2. * cos1 * cosK - cosPrev;
+					cosPrev = cosK;
+					cosK = cosNext;
+				}
+				return a;
+			};
+
+			// the ripples are about Tau / order wide, 8 points each find their peaks
+			const auto numPoints = std::max(64, order * 8);
+			const auto inc = Pi / static_cast<double>(numPoints);
+			auto error = std::max(std::abs(amplitude(wPass) - 1.) / deltaPass,
+				std::abs(amplitude(wStop)) / deltaStop);
+			for (auto i = 0; i <= numPoints; ++i)
+			{
+				const auto w = inc * static_cast<double>(i);
+				if (w <= wPass)
+					error = std::max(error, std::abs(amplitude(w) - 1.) / deltaPass);
+				else if (w >= wStop)
+					error = std::max(error, std::abs(amplitude(w)) / deltaStop);
+			}
+			return error;
+		}
+	}
+
+	template<typename Float>
+	ImpulseResponse<Float>::ImpulseResponse() :
 		buffer(),
+		latency(0.),
 		size(0)
 	{
 	}
 
-	double& ImpulseResponse::operator[](int i)
+	template<typename Float>
+	Float& ImpulseResponse<Float>::operator[](int i)
 	{
 		return buffer[i];
 	}
 
-	const double& ImpulseResponse::operator[](int i) const
+	template<typename Float>
+	const Float& ImpulseResponse<Float>::operator[](int i) const
 	{
 		return buffer[i];
 	}
 
-	/*
-	* Fs, fc, bw, upsampling
-	nyquist == Fs / 2
-	fc < nyquist
-	bw < nyquist
-	fc + bw < nyquist
-	*/
-	void ImpulseResponse::makeLowpass(double Fs, double fc,
-		double bw, bool upsampling)
+	template<typename Float>
+	void ImpulseResponse<Float>::makeLowpass(double Fs, double passband, double stopband,
+		double attenuation, double ripple, bool upsampling, int orderMultiple)
 	{
 		const auto nyquist = Fs * .5;
-		if (fc > nyquist || bw > nyquist || fc + bw > nyquist)
+		if (passband <= 0. || stopband <= passband || stopband > nyquist)
 			return;
 
-		fc /= Fs;
-		bw /= Fs;
+		// the window's ripple is the same in both bands, the smaller one rules
+		const auto deltaPass = std::pow(10., ripple / 20.) - 1.;
+		const auto deltaStop = std::pow(10., -attenuation / 20.);
+		const auto delta = std::min(deltaPass, deltaStop);
+		const auto beta = kaiser::getBeta(-20. * std::log10(delta));
+		const auto wPass = Tau * passband / Fs;
+		const auto wStop = Tau * stopband / Fs;
+		const auto wc = (wPass + wStop) * .5;
+
+		// M is a multiple of orderMultiple (at least even) and fits into the buffer
+		orderMultiple = std::max(2, orderMultiple);
+		const auto roundUp = [orderMultiple](int order)
+		{
+			return (order + orderMultiple - 1) / orderMultiple * orderMultiple;
+		};
+		const auto MMax = (Size - 1) / orderMultiple * orderMultiple;
 
-		auto M = static_cast<int>(4. / bw);
-		if (M % 2 != 0)
-			++M; // M is even number
+		// designed in double precision, then stored as Float
+		std::array<double, Size> design;
+		const auto makeDesign = [&](int M)
+		{
+			const auto MHalf = static_cast<double>(M) * .5;
+			const auto betaI0Inv = 1. / kaiser::besselI0(beta);
+			for (auto n = 0; n <= M; ++n)
+			{
+				const auto i = static_cast<double>(n) - MHalf;
+				const auto sinc = i != 0. ? std::sin(wc * i) / i : wc;
+				const auto x = i / MHalf;
+				const auto w = kaiser::besselI0(beta * std::sqrt(std::max(0., 1. - x * x))) * betaI0Inv;
+				design[n] = sinc * w;
+			}
 
-		const auto Mf = static_cast<double>(M);
-		const auto MHalf = Mf * .5;
-		const auto MInv = 1. / Mf;
+			// exactly symmetric, so that kernels can fold the mirrored taps
+			for (auto n = 0; n < M / 2; ++n)
+			{
+				const auto m = M - n;
+				design[n] = design[m] = (design[n] + design[m]) * .5;
+			}
 
-		size = std::min(Size, M + 1);
+			auto sum = 0.;
+			for (auto n = 0; n <= M; ++n)
+				sum += design[n];
+			for (auto n = 0; n <= M; ++n)
+				design[n] /= sum;
+		};
 
-		const auto h = [&](double i)
-			{ // sinc
-				i -= MHalf;
-				if (i != 0.)
-					return std::sin(Tau * fc * i) / i;
-				return Tau * fc;
-			};
+		const auto meetsTargets = [&](int M)
+		{
+			makeDesign(M);
+			return kaiser::getError(design.data(), M, wPass, wStop, deltaPass, deltaStop) <= 1.;
+		};
 
-		const auto w = [&, tau2 = Tau * 2.](double i)
-			{ // blackman window
-				i *= MInv;
-				return .42 - .5 * std::cos(Tau * i) + .08 * std::cos(tau2 * i);
-			};
+		// kaiser's estimate of the order is off by a few either way
+		auto M = std::min(roundUp(kaiser::getOrder(-20. * std::log10(delta), wStop - wPass)), MMax);
+		if (meetsTargets(M))
+		{
+			while (M > orderMultiple && meetsTargets(M - orderMultiple))
+				M -= orderMultiple;
+		}
+		else
+		{
+			while (M < MMax && !meetsTargets(M + orderMultiple))
+				M += orderMultiple;
+			M = std::min(M + orderMultiple, MMax);
+		}
+		makeDesign(M);
+
+		size = M + 1;
+		latency = static_cast<double>(M / 2);
+
+		const auto targetGain = upsampling ? 2. : 1.;
+		for (auto n = 0; n < size; ++n)
+			buffer[n] = static_cast<Float>(design[n] * targetGain);
+	}
 
+	template<typename Float>
+	void ImpulseResponse<Float>::makeHalfband(double Fs, double fc, double attenuation,
+		double ripple, bool upsampling, int orderMultiple)
+	{
+		// both bands are equally wide, so the cutoff lands on Fs / 4.
+		// images of the passband can only alias into the transition
+		if (fc <= 0. || fc >= Fs * .25)
+			return;
+		makeLowpass(Fs, fc, Fs * .5 - fc, attenuation, ripple, upsampling, orderMultiple);
+
+		// the sinc is 0 at every even distance from the center
+		const auto center = (size - 1) / 2;
+		auto sum = 0.;
 		for (auto n = 0; n < size; ++n)
 		{
-			auto nF = static_cast<double>(n);
-			buffer[n] = h(nF) * w(nF);
+			const auto distance = n - center;
+			if (distance != 0 && distance % 2 == 0)
+				buffer[n] = static_cast<Float>(0);
+			sum += static_cast<double>(buffer[n]);
 		}
 
 		const auto targetGain = upsampling ? 2. : 1.;
-		auto sum = 0.; // normalize
+		const auto gain = targetGain / sum;
+		for (auto n = 0; n < size; ++n)
+			buffer[n] = static_cast<Float>(static_cast<double>(buffer[n]) * gain);
+	}
+
+	template<typename Float>
+	void ImpulseResponse<Float>::makePhase(const ImpulseResponse& ir, int phase, int numPhases)
+	{
+		size = 0;
+		for (auto n = phase; n < ir.size; n += numPhases, ++size)
+			buffer[size] = ir[n];
+		latency = ir.latency / static_cast<double>(numPhases);
+	}
+
+	template<typename Float>
+	void ImpulseResponse<Float>::makeMinimumPhase()
+	{
+		using FFT = FFTComplex<double>;
+		using Complex = FFT::Complex;
+
+		// zero-padding keeps the cepstrum's time aliasing low
+		auto order = 4;
+		while ((1 << order) < size * 16)
+			++order;
+		FFT fft;
+		fft.prepare(order);
+		const auto fftSize = fft.getSize();
+		const auto fftSizeInv = 1. / static_cast<double>(fftSize);
+		std::vector<Complex> bins(fftSize, Complex());
+
+		auto sum = 0.;
+		for (auto n = 0; n < size; ++n)
+		{
+			bins[n] = Complex(static_cast<double>(buffer[n]), 0.);
+			sum += bins[n].real();
+		}
+
+		// real cepstrum of the magnitude response.
+		// the floor keeps the stopband's zeros finite
+		fft.forward(bins.data());
+		for (auto& bin : bins)
+			bin = Complex(std::log(std::max(std::abs(bin), 1e-12)), 0.);
+		fft.inverse(bins.data());
+
+		// folding the anticausal part onto the causal one makes it minimum phase
+		const auto fftSizeHalf = fftSize / 2;
+		bins[0] *= fftSizeInv;
+		for (auto n = 1; n < fftSizeHalf; ++n)
+			bins[n] *= 2. * fftSizeInv;
+		bins[fftSizeHalf] *= fftSizeInv;
+		for (auto n = fftSizeHalf + 1; n < fftSize; ++n)
+			bins[n] = Complex();
+
+		fft.forward(bins.data());
+		for (auto& bin : bins)
+			bin = std::exp(bin);
+		fft.inverse(bins.data());
+
+		// same gain as before, the group delay at dc is the ir's centroid
+		auto sumMin = 0.;
 		for (auto n = 0; n < size; ++n)
-			sum += buffer[n];
-		const auto sumInv = targetGain / sum;
+			sumMin += bins[n].real();
+		const auto gain = sum / sumMin;
+		auto centroid = 0.;
 		for (auto n = 0; n < size; ++n)
-			buffer[n] *= sumInv;
+		{
+			const auto y = bins[n].real() * gain;
+			buffer[n] = static_cast<Float>(y);
+			centroid += static_cast<double>(n) * y;
+		}
+		latency = centroid / sum;
 	}
 
-	/*
-	* Fs, fc, upsampling
-	nyquist == Fs / 2
-	fc < nyquist
-	*/
-	void ImpulseResponse::makeLowpass(double Fs, double fc, bool upsampling)
+	template<typename Float>
+	double ImpulseResponse<Float>::getLatency() const noexcept
 	{
-		const auto bw = Fs * .25 - fc - 1.;
-		makeLowpass(Fs, fc, bw, upsampling);
+		return latency;
 	}
 
-	int ImpulseResponse::getLatency() const noexcept
+	template struct ImpulseResponse<float>;
+	template struct ImpulseResponse<double>;
+
+	template<typename Float>
+	ConvolverKernel<Float>::ConvolverKernel() :
+		coefs(),
+		size(0),
+		delayIdx(0),
+		form(Form::Generic)
 	{
-		return size / 2;
 	}
 
-	using ConvolverBuffer = std::array<ImpulseResponse::Buffer, NumChannels>;
+	template<typename Float>
+	void ConvolverKernel<Float>::prepare(const ImpulseResponse<Float>& ir) noexcept
+	{
+		size = ir.size;
+		const auto max = size - 1;
+		for (auto i = 0; i < size; ++i)
+			coefs[i] = Vec2<Float>::fill(ir[max - i]);
+
+		const auto zero = static_cast<Float>(0);
+		auto numNonZero = 0;
+		for (auto i = 0; i < size; ++i)
+			if (ir[i] != zero)
+			{
+				++numNonZero;
+				delayIdx = max - i;
+			}
 
-	Convolver::Convolver(const ImpulseResponse& ir) :
-		ir(ir),
-		ringBuffer()
+		auto symmetric = true;
+		for (auto i = 0; i < size / 2; ++i)
+			if (ir[i] != ir[max - i])
+				symmetric = false;
+
+		if (numNonZero == 1)
+			form = Form::Delay;
+		else if (symmetric && size > 1)
+			form = Form::Symmetric;
+		else
+			form = Form::Generic;
+	}
+
+	template<typename Float>
+	int ConvolverKernel<Float>::getNumMultiplies() const noexcept
 	{
+		switch (form)
+		{
+		case Form::Delay: return 1;
+		case Form::Symmetric: return (size + 1) / 2;
+		default: return size;
+		}
 	}
 
-	void Convolver::processBlock(double* const* samples, const int* wHead,
-		int numChannels, int numSamples) noexcept
+	template struct ConvolverKernel<float>;
+	template struct ConvolverKernel<double>;
+
+	template<typename Float>
+	ConvolverHistory<Float>::ConvolverHistory() :
+		buffer(2, Vec::fill(static_cast<Float>(0))),
+		wHead(0),
+		size(1)
 	{
-		for (auto ch = 0; ch < numChannels; ++ch)
+	}
+
+	template<typename Float>
+	void ConvolverHistory<Float>::prepare(int _size)
+	{
+		size = std::max(1, _size);
+		wHead = 0;
+		buffer.assign(size * 2, Vec::fill(static_cast<Float>(0)));
+	}
+
+	template<typename Float>
+	void ConvolverHistory<Float>::push(Vec x) noexcept
+	{
+		if (++wHead == size)
+			wHead = 0;
+		buffer[wHead] = x;
+		buffer[wHead + size] = x;
+	}
+
+	template<typename Float>
+	typename ConvolverHistory<Float>::Vec ConvolverHistory<Float>::convolve(const ConvolverKernel<Float>& kernel) const noexcept
+	{
+		using Form = typename ConvolverKernel<Float>::Form;
+
+		// the latest input is at wHead + size, the window ends there
+		const auto numTaps = kernel.size;
+		const auto x = &buffer[wHead + size - numTaps + 1];
+		const auto h = kernel.coefs.data();
+
+		if (kernel.form == Form::Delay)
+		{
+			const auto i = kernel.delayIdx;
+			return h[i] * x[i];
+		}
+
+		// independent sums hide the latency of the additions
+		const auto zero = Vec::fill(static_cast<Float>(0));
+		auto y0 = zero, y1 = zero, y2 = zero, y3 = zero;
+
+		if (kernel.form == Form::Symmetric)
 		{
-			auto smpls = samples[ch];
-			auto ring = ringBuffer[ch].data();
+			const auto numPairs = numTaps / 2;
+			const auto max = numTaps - 1;
+			auto i = 0;
+			for (; i + 2 <= numPairs; i += 2)
+			{
+				y0 = y0 + h[i] * (x[i] + x[max - i]);
+				y1 = y1 + h[i + 1] * (x[i + 1] + x[max - i - 1]);
+			}
+			for (; i < numPairs; ++i)
+				y2 = y2 + h[i] * (x[i] + x[max - i]);
+			if (numTaps % 2 == 1)
+				y3 = h[numPairs] * x[numPairs];
 
-			processBlock(smpls, ring, wHead, numSamples);
+			return (y0 + y1) + (y2 + y3);
 		}
+
+		auto i = 0;
+		for (; i + 4 <= numTaps; i += 4)
+		{
+			y0 = y0 + h[i] * x[i];
+			y1 = y1 + h[i + 1] * x[i + 1];
+			y2 = y2 + h[i + 2] * x[i + 2];
+			y3 = y3 + h[i + 3] * x[i + 3];
+		}
+		for (; i < numTaps; ++i)
+			y0 = y0 + h[i] * x[i];
+
+		return (y0 + y1) + (y2 + y3);
+	}
+
+	template struct ConvolverHistory<float>;
+	template struct ConvolverHistory<double>;
+
+	template<typename Float>
+	Convolver<Float>::Convolver() :
+		kernel(nullptr),
+		history()
+	{
 	}
 
-	void Convolver::processBlock(double* smpls, double* ring,
-		const int* wHead, int numSamples) noexcept
+	template<typename Float>
+	void Convolver<Float>::prepare(const ConvolverKernel<Float>& _kernel)
 	{
+		kernel = &_kernel;
+		history.prepare(kernel->size);
+	}
+
+	template<typename Float>
+	void Convolver<Float>::processBlock(Float* const* samples, int numChannels, int numSamples) noexcept
+	{
+		using Vec = Vec2<Float>;
+
+		auto smplsL = samples[0];
+		auto smplsR = samples[numChannels - 1];
+
 		for (auto s = 0; s < numSamples; ++s)
-			smpls[s] = processSample(smpls[s], ring, wHead[s]);
+		{
+			history.push(Vec::load(&smplsL[s], &smplsR[s]));
+			const auto y = history.convolve(*kernel);
+			y.store(&smplsL[s], &smplsR[s]);
+		}
+	}
+
+	template struct Convolver<float>;
+	template struct Convolver<double>;
+
+	template<typename Float>
+	PolyphaseUpsampler<Float>::PolyphaseUpsampler() :
+		phase0(nullptr),
+		phase1(nullptr),
+		history()
+	{
+	}
+
+	template<typename Float>
+	void PolyphaseUpsampler<Float>::prepare(const ConvolverKernel<Float>& _phase0,
+		const ConvolverKernel<Float>& _phase1)
+	{
+		phase0 = &_phase0;
+		phase1 = &_phase1;
+		history.prepare(std::max(phase0->size, phase1->size));
 	}
 
-	double Convolver::processSample(double smpl, double* ring, int w) noexcept
+	template<typename Float>
+	void PolyphaseUpsampler<Float>::operator()(Float* const* samplesUp, const Float* const* samplesIn,
+		int numChannels, int numSamples1x) noexcept
 	{
-		ring[w] = smpl;
+		using Vec = Vec2<Float>;
 
-		auto r = w;
-		auto y = ring[r] * ir[0];
+		const auto inL = samplesIn[0];
+		const auto inR = samplesIn[numChannels - 1];
+		auto upL = samplesUp[0];
+		auto upR = samplesUp[numChannels - 1];
 
-		const auto size = ir.size;
-		const auto max = size - 1;
-		for (auto i = 1; i < size; ++i)
+		for (auto s = 0; s < numSamples1x; ++s)
 		{
-			--r;
-			if (r == -1)
-				r = max;
+			Vec y0, y1;
+			operator()(Vec::load(&inL[s], &inR[s]), y0, y1);
+
+			const auto s2 = s * 2;
+			y0.store(&upL[s2], &upR[s2]);
+			y1.store(&upL[s2 + 1], &upR[s2 + 1]);
+		}
+	}
+
+	template<typename Float>
+	void PolyphaseUpsampler<Float>::operator()(Vec2<Float> x, Vec2<Float>& y0, Vec2<Float>& y1) noexcept
+	{
+		history.push(x);
+		y0 = history.convolve(*phase0);
+		y1 = history.convolve(*phase1);
+	}
+
+	template struct PolyphaseUpsampler<float>;
+	template struct PolyphaseUpsampler<double>;
+
+	template<typename Float>
+	PolyphaseDecimator<Float>::PolyphaseDecimator() :
+		phase0(nullptr),
+		phase1(nullptr),
+		historyEven(), historyOdd(),
+		prevOdd(Vec2<Float>::fill(static_cast<Float>(0)))
+	{
+	}
+
+	template<typename Float>
+	void PolyphaseDecimator<Float>::prepare(const ConvolverKernel<Float>& _phase0,
+		const ConvolverKernel<Float>& _phase1)
+	{
+		phase0 = &_phase0;
+		phase1 = &_phase1;
+		historyEven.prepare(phase0->size);
+		historyOdd.prepare(phase1->size);
+		prevOdd = Vec2<Float>::fill(static_cast<Float>(0));
+	}
+
+	template<typename Float>
+	void PolyphaseDecimator<Float>::operator()(Float* const* samplesOut, const Float* const* samplesUp,
+		int numChannels, int numSamples1x) noexcept
+	{
+		using Vec = Vec2<Float>;
+
+		const auto upL = samplesUp[0];
+		const auto upR = samplesUp[numChannels - 1];
+		auto outL = samplesOut[0];
+		auto outR = samplesOut[numChannels - 1];
 
-			y += ring[r] * ir[i];
+		for (auto s = 0; s < numSamples1x; ++s)
+		{
+			const auto s2 = s * 2;
+			const auto y = operator()(Vec::load(&upL[s2], &upR[s2]), Vec::load(&upL[s2 + 1], &upR[s2 + 1]));
+			y.store(&outL[s], &outR[s]);
 		}
+	}
 
-		return y;
+	template<typename Float>
+	Vec2<Float> PolyphaseDecimator<Float>::operator()(Vec2<Float> x0, Vec2<Float> x1) noexcept
+	{
+		// y[2m] = sum h[2j] * u[2m - 2j] + sum h[2j + 1] * u[2m - 1 - 2j]
+		historyEven.push(x0);
+		historyOdd.push(prevOdd);
+		prevOdd = x1;
+		return historyEven.convolve(*phase0) + historyOdd.convolve(*phase1);
 	}
 
+	template struct PolyphaseDecimator<float>;
+	template struct PolyphaseDecimator<double>;
+
 	/* samplesUp, samplesIn, numChannels, numSamples1x */
-	void zeroStuff(double* const* samplesUp, const double* const* samplesIn,
+	template<typename Float>
+	void zeroStuff(Float* const* samplesUp, const Float* const* samplesIn,
 		int numChannels, int numSamples1x) noexcept
 	{
 		for (auto ch = 0; ch < numChannels; ++ch)
@@ -151,13 +571,14 @@ namespace dsp
 			{
 				const auto s2 = s * 2;
 				upBuf[s2] = inBuf[s];
-				upBuf[s2 + 1] = 0.;
+				upBuf[s2 + 1] = static_cast<Float>(0);
 			}
 		}
 	}
 
 	/* samplesOut, samplesUp, numChannels, numSamples1x */
-	void decimate(double* const* samplesOut, const double* const* samplesUp,
+	template<typename Float>
+	void decimate(Float* const* samplesOut, const Float* const* samplesUp,
 		int numChannels, int numSamples1x) noexcept
 	{
 		for (auto ch = 0; ch < numChannels; ++ch)
@@ -170,60 +591,357 @@ namespace dsp
 		}
 	}
 
-	Oversampler::Oversampler() :
+	OversamplerTargets getOversamplerTargets(OversamplerQuality quality) noexcept
+	{
+		switch (quality)
+		{
+		case OversamplerQuality::Eco: return { 18000., .1, 72., 192000. };
+		case OversamplerQuality::Mastering: return { 20000., .01, 120., 768000. };
+		default: return { 20000., .05, 96., 384000. };
+		}
+	}
+
+	OversamplingOrder getOversamplingOrderAuto(double sampleRate, OversamplerQuality quality) noexcept
+	{
+		const auto maxRateUp = getOversamplerTargets(quality).maxRateUp;
+		auto order = 0;
+		auto sampleRateUp = sampleRate * 2.;
+		while (order < static_cast<int>(OversamplingOrder::x16) && sampleRateUp <= maxRateUp)
+		{
+			sampleRateUp *= 2.;
+			++order;
+		}
+		return static_cast<OversamplingOrder>(order);
+	}
+
+	template<typename Float>
+	bool OversamplerDesign<Float>::Key::operator<(const Key& other) const noexcept
+	{
+		return std::tie(sampleRateUp, passband, stopband, attenuationDb, rippleDb,
+			orderMultiple, shape, minimumPhase, polyphase) <
+			std::tie(other.sampleRateUp, other.passband, other.stopband, other.attenuationDb,
+				other.rippleDb, other.orderMultiple, other.shape, other.minimumPhase, other.polyphase);
+	}
+
+	template<typename Float>
+	OversamplerDesign<Float>::OversamplerDesign(const Key& key) :
+		kernelsUp(),
+		kernelsDown(),
+		latencyUp(0.),
+		latencyDown(0.),
+		polyphase(key.polyphase)
+	{
+		using IR = ImpulseResponse<Float>;
+		// only needed while designing, too large for the stack
+		auto irUp = std::make_unique<IR>();
+		auto irDown = std::make_unique<IR>();
+
+		if (key.shape == Shape::Halfband)
+			irDown->makeHalfband(key.sampleRateUp, key.passband,
+				key.attenuationDb, key.rippleDb, false, key.orderMultiple);
+		else
+			irDown->makeLowpass(key.sampleRateUp, key.passband, key.stopband,
+				key.attenuationDb, key.rippleDb, false, key.orderMultiple);
+
+		if (key.minimumPhase)
+			irDown->makeMinimumPhase();
+
+		// the interpolator is the same filter with the gain of the zero-stuffing
+		*irUp = *irDown;
+		for (auto n = 0; n < irUp->size; ++n)
+			(*irUp)[n] *= static_cast<Float>(2);
+
+		latencyUp = irUp->getLatency();
+		latencyDown = irDown->getLatency();
+
+		if (polyphase)
+		{
+			auto phaseUp = std::make_unique<IR>();
+			auto phaseDown = std::make_unique<IR>();
+			for (auto p = 0; p < 2; ++p)
+			{
+				phaseUp->makePhase(*irUp, p, 2);
+				phaseDown->makePhase(*irDown, p, 2);
+				kernelsUp[p].prepare(*phaseUp);
+				kernelsDown[p].prepare(*phaseDown);
+			}
+		}
+		else
+		{
+			kernelsUp[0].prepare(*irUp);
+			kernelsDown[0].prepare(*irDown);
+		}
+	}
+
+	template struct OversamplerDesign<float>;
+	template struct OversamplerDesign<double>;
+
+	template<typename Float>
+	std::mutex& OversamplerDesignCache<Float>::getMutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	template<typename Float>
+	std::map<typename OversamplerDesign<Float>::Key, std::weak_ptr<const OversamplerDesign<Float>>>&
+		OversamplerDesignCache<Float>::getDesigns()
+	{
+		static std::map<typename Design::Key, std::weak_ptr<const Design>> designs;
+		return designs;
+	}
+
+	template<typename Float>
+	typename OversamplerDesignCache<Float>::DesignPtr OversamplerDesignCache<Float>::get(const typename Design::Key& key)
+	{
+		// designing happens under the lock, so that instances
+		// preparing at the same time don't design the same filters twice
+		std::lock_guard<std::mutex> lock(getMutex());
+		auto& designs = getDesigns();
+
+		auto& entry = designs[key];
+		if (auto design = entry.lock())
+			return design;
+
+		for (auto it = designs.begin(); it != designs.end();)
+		{
+			if (&it->second != &entry && it->second.expired())
+				it = designs.erase(it);
+			else
+				++it;
+		}
+
+		DesignPtr design = std::make_shared<const Design>(key);
+		entry = design;
+		return design;
+	}
+
+	template<typename Float>
+	int OversamplerDesignCache<Float>::getNumDesigns()
+	{
+		std::lock_guard<std::mutex> lock(getMutex());
+		auto numDesigns = 0;
+		for (const auto& entry : getDesigns())
+			if (!entry.second.expired())
+				++numDesigns;
+		return numDesigns;
+	}
+
+	template struct OversamplerDesignCache<float>;
+	template struct OversamplerDesignCache<double>;
+
+	template<typename Float>
+	OversamplerStage<Float>::OversamplerStage() :
+		design(),
+		filterUp(), filterDown(),
+		polyUp(), polyDown(),
+		iir(),
+		mode(Mode::Polyphase)
+	{
+	}
+
+	template<typename Float>
+	void OversamplerStage<Float>::prepare(double sampleRateUp, const OversamplerTargets& targets,
+		double stopband, int orderMultiple, Mode _mode)
+	{
+		mode = _mode;
+		prepareStructure({ sampleRateUp, targets.passband, stopband, targets.attenuationDb,
+			targets.rippleDb, orderMultiple, Design::Shape::Lowpass,
+			mode == Mode::MinimumPhase, mode != Mode::Direct });
+	}
+
+	template<typename Float>
+	void OversamplerStage<Float>::prepareHalfband(double sampleRateUp, const OversamplerTargets& targets,
+		int orderMultiple, Mode _mode)
+	{
+		mode = _mode;
+		prepareStructure({ sampleRateUp, targets.passband, sampleRateUp * .5 - targets.passband,
+			targets.attenuationDb, targets.rippleDb, orderMultiple, Design::Shape::Halfband,
+			mode == Mode::MinimumPhase, mode != Mode::Direct });
+	}
+
+	template<typename Float>
+	void OversamplerStage<Float>::prepareStructure(typename Design::Key key)
+	{
+		design = OversamplerDesignCache<Float>::get(key);
+
+		// only the filters differ, they run through the polyphase structure
+		if (mode != Mode::Direct)
+			mode = Mode::Polyphase;
+
+		const auto& d = *design;
+		if (mode == Mode::Polyphase)
+		{
+			polyUp.prepare(d.kernelsUp[0], d.kernelsUp[1]);
+			polyDown.prepare(d.kernelsDown[0], d.kernelsDown[1]);
+		}
+		else
+		{
+			filterUp.prepare(d.kernelsUp[0]);
+			filterDown.prepare(d.kernelsDown[0]);
+		}
+	}
+
+	template<typename Float>
+	void OversamplerStage<Float>::prepareIIR(double sampleRateUp, const OversamplerTargets& targets)
+	{
+		mode = Mode::IIR;
+		design.reset();
+		// the stopband starts where the images of the passband do
+		const auto transition = .5 - 2. * targets.passband / sampleRateUp;
+		iir.prepare(targets.attenuationDb, transition);
+	}
+
+	template<typename Float>
+	void OversamplerStage<Float>::upsample(Float* const* samplesUp, const Float* const* samplesIn,
+		int numChannels, int numSamplesIn) noexcept
+	{
+		if (mode == Mode::IIR)
+			iir.upsample(samplesUp, samplesIn, numChannels, numSamplesIn);
+		else if (mode == Mode::Polyphase)
+			polyUp(samplesUp, samplesIn, numChannels, numSamplesIn);
+		else
+		{
+			const auto numSamplesUp = numSamplesIn * 2;
+
+			zeroStuff(samplesUp, samplesIn, numChannels, numSamplesIn);
+			filterUp.processBlock(samplesUp, numChannels, numSamplesUp);
+		}
+	}
+
+	template<typename Float>
+	void OversamplerStage<Float>::downsample(Float* const* samplesOut, Float* const* samplesUp,
+		int numChannels, int numSamplesOut) noexcept
+	{
+		if (mode == Mode::IIR)
+			iir.downsample(samplesOut, samplesUp, numChannels, numSamplesOut);
+		else if (mode == Mode::Polyphase)
+			polyDown(samplesOut, samplesUp, numChannels, numSamplesOut);
+		else
+		{
+			// filter 2x + decimating
+			filterDown.processBlock(samplesUp, numChannels, numSamplesOut * 2);
+			decimate(samplesOut, samplesUp, numChannels, numSamplesOut);
+		}
+	}
+
+	template<typename Float>
+	void OversamplerStage<Float>::upsample(Vec2<Float> x, Vec2<Float>& y0, Vec2<Float>& y1) noexcept
+	{
+		if (mode == Mode::IIR)
+			iir.upsample(x, y0, y1);
+		else
+			polyUp(x, y0, y1);
+	}
+
+	template<typename Float>
+	Vec2<Float> OversamplerStage<Float>::downsample(Vec2<Float> x0, Vec2<Float> x1) noexcept
+	{
+		if (mode == Mode::IIR)
+			return iir.downsample(x0, x1);
+		return polyDown(x0, x1);
+	}
+
+	template<typename Float>
+	bool OversamplerStage<Float>::canFuse() const noexcept
+	{
+		return mode == Mode::IIR || mode == Mode::Polyphase;
+	}
+
+	template<typename Float>
+	double OversamplerStage<Float>::getLatency() const noexcept
+	{
+		if (mode == Mode::IIR)
+			return iir.getLatency();
+
+		return design->latencyUp + design->latencyDown;
+	}
+
+	template struct OversamplerStage<float>;
+	template struct OversamplerStage<double>;
+
+	template<typename Float>
+	Oversampler<Float>::Oversampler() :
 		sampleRate(0.),
-		bufferUp(),
+		buffers(),
 		bufferInfo(),
-		irUp(), irDown(),
-		wHead(),
-		filterUp(irUp), filterDown(irDown),
+		stages(),
+		numStages(0),
 		sampleRateUp(0.),
 		numSamplesUp(0),
+		order(OversamplingOrder::x1),
+		mode(Mode::Polyphase),
+		quality(Quality::Balanced),
 		enabled(false)
 	{
 	}
 
-	void Oversampler::prepare(const double _sampleRate, bool _enabled)
+	template<typename Float>
+	void Oversampler<Float>::prepare(const double _sampleRate, OversamplingOrder _order,
+		Mode _mode, Quality _quality)
 	{
 		sampleRate = _sampleRate;
-		enabled = _enabled;
+		order = _order;
+		mode = _mode;
+		quality = _quality;
 
-		if (enabled)
-		{
-			sampleRateUp = sampleRate * 2.;
+		auto targets = getOversamplerTargets(quality);
+		// keeps a transition band at host rates below 40khz
+		targets.passband = std::min(targets.passband, sampleRate * .475);
 
-			irUp.makeLowpass(sampleRateUp, LPCutoff, true);
-			irDown.makeLowpass(sampleRateUp, LPCutoff, false);
-			const auto irSize = static_cast<int>(irUp.size);
-			wHead.prepare(irSize);
-		}
-		else
+		numStages = static_cast<int>(order);
+		sampleRateUp = sampleRate * static_cast<double>(1 << numStages);
+		enabled = numStages != 0;
+
+		auto sampleRateIn = sampleRate;
+		for (auto i = 0; i < numStages; ++i)
 		{
-			sampleRateUp = sampleRate;
+			const auto stageRateUp = sampleRateIn * 2.;
+			if (mode == Mode::IIR)
+				stages[i].prepareIIR(stageRateUp, targets);
+			else if (i == 0 && mode != Mode::Halfband)
+			{
+				// stops at the host's nyquist, nothing aliases back
+				stages[i].prepare(stageRateUp, targets, sampleRate * .5, 2, mode);
+			}
+			else
+			{
+				// passband ends where the targets say, images of it start at sampleRateIn - passband.
+				// the order is a multiple of 2^(i+1), so that the stage's latency
+				// is a whole number of samples at the host rate
+				stages[i].prepareHalfband(stageRateUp, targets, 2 << i, mode);
+			}
+			sampleRateIn = stageRateUp;
 		}
 	}
 
-	Oversampler::BufferInfo Oversampler::upsample(double* const* samples,
+	template<typename Float>
+	typename Oversampler<Float>::BufferInfo Oversampler<Float>::upsample(Float* const* samples,
 		int numChannels, int numSamples) noexcept
 	{
 		bufferInfo.numChannels = numChannels;
 
 		if (enabled)
 		{
-			bufferInfo.numSamples = numSamplesUp = numSamples * 2;
-			bufferInfo.smplsL = bufferUp[0].data();
-			bufferInfo.smplsR = bufferUp[1].data();
-			double* samplesUp[] = { bufferInfo.smplsL, bufferInfo.smplsR };
-
-			wHead(numSamplesUp);
-			const auto wHeadData = wHead.data();
+			const Float* samplesIn[] = { samples[0], samples[numChannels - 1] };
+			auto numSamplesIn = numSamples;
+			for (auto i = 0; i < numStages; ++i)
+			{
+				auto& buffer = buffers[i];
+				Float* samplesUp[] = { buffer[0].data(), buffer[1].data() };
+				stages[i].upsample(samplesUp, samplesIn, numChannels, numSamplesIn);
 
-			zeroStuff(samplesUp, samples, numChannels, numSamples);
-			filterUp.processBlock(samplesUp, wHeadData, numChannels, numSamplesUp);
+				samplesIn[0] = samplesUp[0];
+				samplesIn[1] = samplesUp[1];
+				numSamplesIn *= 2;
+			}
+			bufferInfo.smplsL = buffers[numStages - 1][0].data();
+			bufferInfo.smplsR = buffers[numStages - 1][1].data();
+			bufferInfo.numSamples = numSamplesUp = numSamplesIn;
 		}
 		else
 		{
-			bufferInfo.numSamples = numSamples;
+			bufferInfo.numSamples = numSamplesUp = numSamples;
 			bufferInfo.smplsL = samples[0];
 			bufferInfo.smplsR = samples[1];
 		}
@@ -231,23 +949,59 @@ namespace dsp
 		return bufferInfo;
 	}
 
-	void Oversampler::downsample(double* const* samplesOut, int numSamples) noexcept
+	template<typename Float>
+	void Oversampler<Float>::downsample(Float* const* samplesOut, int numSamples) noexcept
 	{
 		if (enabled)
 		{
 			const auto numChannels = bufferInfo.numChannels;
-			const auto wHeadData = wHead.data();
 
-			double* samplesUp[] = { bufferInfo.smplsL, bufferInfo.smplsR };
-
-			// filter 2x + decimating
-			filterDown.processBlock(samplesUp, wHeadData, numChannels, numSamplesUp);
-			decimate(samplesOut, samplesUp, numChannels, numSamples);
+			for (auto i = numStages - 1; i > -1; --i)
+			{
+				auto& bufferUp = buffers[i];
+				Float* samplesUp[] = { bufferUp[0].data(), bufferUp[1].data() };
+				const auto numSamplesOut = numSamples << i;
+
+				if (i == 0)
+					stages[i].downsample(samplesOut, samplesUp, numChannels, numSamplesOut);
+				else
+				{
+					auto& bufferDown = buffers[i - 1];
+					Float* samplesDown[] = { bufferDown[0].data(), bufferDown[1].data() };
+					stages[i].downsample(samplesDown, samplesUp, numChannels, numSamplesOut);
+				}
+			}
 		}
 	}
 
-	int Oversampler::getLatency() const noexcept
+	template<typename Float>
+	bool Oversampler<Float>::canFuse() const noexcept
 	{
-		return enabled ? (irUp.getLatency() + irDown.getLatency() / 2) : 0;
+		if (!enabled)
+			return false;
+		for (auto i = 0; i < numStages; ++i)
+			if (!stages[i].canFuse())
+				return false;
+		return true;
 	}
-}
\ No newline at end of file
+
+	template<typename Float>
+	int Oversampler<Float>::getLatency() const noexcept
+	{
+		// each stage delays by its filters' latency at its upsampled rate.
+		// the fir stages add up to whole samples, the iir's group delay is rounded
+		auto latency = 0.;
+		for (auto i = 0; i < numStages; ++i)
+			latency += stages[i].getLatency() / static_cast<double>(2 << i);
+		return static_cast<int>(std::round(latency));
+	}
+
+	template<typename Float>
+	int Oversampler<Float>::getFactor() const noexcept
+	{
+		return 1 << numStages;
+	}
+
+	template struct Oversampler<float>;
+	template struct Oversampler<double>;
+}
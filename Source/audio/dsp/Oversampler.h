@@ -1,98 +1,381 @@
 #pragma once
-#include "WHead.h"
+#include "FFT.h"
+#include "HalfbandIIR.h"
+#include <map>
+#include <memory>
+#include <mutex>
 
 namespace dsp
 {
-	
+	template<typename Float>
 	struct ImpulseResponse
 	{
-		static constexpr int Size = 1 << 8;
-		using Buffer = std::array<double, Size>;
+		static constexpr int Size = 1 << 11;
+		using Buffer = std::array<Float, Size>;
 
 		ImpulseResponse();
 
-		double& operator[](int);
+		Float& operator[](int);
 
-		const double& operator[](int) const;
+		const Float& operator[](int) const;
 
 		/*
-		* Fs, fc, bw, upsampling
+		* Fs, passband, stopband, attenuationDb, rippleDb, upsampling, orderMultiple
 		nyquist == Fs / 2
-		fc < nyquist
-		bw < nyquist
-		fc + bw < nyquist
+		passband < stopband <= nyquist
+		kaiser windowed sinc, the shortest one that stays within rippleDb of unity gain
+		up to passband and at least attenuationDb down from stopband on.
+		the filter order is a multiple of orderMultiple
 		*/
-		void makeLowpass(double, double, double, bool);
+		void makeLowpass(double, double, double, double, double, bool, int = 2);
 
 		/*
-		* Fs, fc, upsampling
-		nyquist == Fs / 2
-		fc < nyquist
+		* Fs, fc, attenuationDb, rippleDb, upsampling, orderMultiple
+		lowpass centered on Fs / 4, passband up to fc, stopband from Fs / 2 - fc.
+		every second coefficient, except the center one, is exactly 0
 		*/
-		void makeLowpass(double, double, bool);
+		void makeHalfband(double, double, double, double, bool, int = 2);
 
-		int getLatency() const noexcept;
+		/* ir, phase, numPhases
+		takes every numPhases-th coefficient of ir, starting at phase */
+		void makePhase(const ImpulseResponse&, int, int);
+
+		/* turns the filter into its minimum phase counterpart (cepstral method).
+		same magnitude response, but the energy moves to the start of the ir. allocates */
+		void makeMinimumPhase();
+
+		/* group delay at dc in samples */
+		double getLatency() const noexcept;
 
 	private:
 		Buffer buffer;
+		double latency;
 	public:
 		int size;
 	};
 
-	using ConvolverBuffer = std::array<ImpulseResponse::Buffer, NumChannels>;
+	/* an impulse response reversed, with each coefficient in both lanes of Vec2.
+	Symmetric kernels add mirrored inputs before multiplying,
+	Delay kernels have a single non-zero coefficient, like the center phase of a half-band */
+	template<typename Float>
+	struct ConvolverKernel
+	{
+		enum class Form { Generic, Symmetric, Delay };
+
+		ConvolverKernel();
 
+		/* ir */
+		void prepare(const ImpulseResponse<Float>&) noexcept;
+
+		/* multiplications per output */
+		int getNumMultiplies() const noexcept;
+
+		std::array<Vec2<Float>, ImpulseResponse<Float>::Size> coefs;
+		int size, delayIdx;
+		Form form;
+	};
+
+	/* the latest inputs of a stereo pair, written twice into a buffer of twice the size.
+	any window of the history is contiguous that way, so a convolution is a plain
+	dot product without wrapping the read head */
+	template<typename Float>
+	struct ConvolverHistory
+	{
+		using Vec = Vec2<Float>;
+
+		ConvolverHistory();
+
+		/* size, at least the size of the largest kernel. allocates */
+		void prepare(int);
+
+		/* x */
+		void push(Vec) noexcept;
+
+		/* kernel, convolves the latest kernel.size inputs with it */
+		Vec convolve(const ConvolverKernel<Float>&) const noexcept;
+
+	private:
+		std::vector<Vec> buffer;
+		int wHead, size;
+	};
+
+	/* direct form fir of a stereo pair */
+	template<typename Float>
 	struct Convolver
 	{
-		Convolver(const ImpulseResponse&);
+		Convolver();
 
-		/* samples, wHead, numChannels, numSamples */
-		void processBlock(double* const*, const int*, int, int) noexcept;
+		/* kernel, has to outlive the convolver's use of it. allocates */
+		void prepare(const ConvolverKernel<Float>&);
 
-		/* smpls, ring, whead, numSamples */
-		void processBlock(double*, double*, const int*, int) noexcept;
+		/* samples, numChannels, numSamples */
+		void processBlock(Float* const*, int, int) noexcept;
 
-		/* smpl, ring, w */
-		double processSample(double, double*, int) noexcept;
+	private:
+		const ConvolverKernel<Float>* kernel;
+		ConvolverHistory<Float> history;
+	};
+
+	/* 2x interpolator that only runs the coefficients
+	which would meet the non-zero samples of a zero-stuffed signal */
+	template<typename Float>
+	struct PolyphaseUpsampler
+	{
+		PolyphaseUpsampler();
+
+		/* phase0, phase1, allocates */
+		void prepare(const ConvolverKernel<Float>&, const ConvolverKernel<Float>&);
+
+		/* samplesUp, samplesIn, numChannels, numSamples1x */
+		void operator()(Float* const*, const Float* const*, int, int) noexcept;
+
+		/* x, y0, y1 */
+		void operator()(Vec2<Float>, Vec2<Float>&, Vec2<Float>&) noexcept;
+
+	private:
+		const ConvolverKernel<Float>* phase0;
+		const ConvolverKernel<Float>* phase1;
+		ConvolverHistory<Float> history;
+	};
+
+	/* 2x decimator that only computes the samples that are kept */
+	template<typename Float>
+	struct PolyphaseDecimator
+	{
+		PolyphaseDecimator();
+
+		/* phase0, phase1, allocates */
+		void prepare(const ConvolverKernel<Float>&, const ConvolverKernel<Float>&);
+
+		/* samplesOut, samplesUp, numChannels, numSamples1x */
+		void operator()(Float* const*, const Float* const*, int, int) noexcept;
+
+		/* x0, x1, returns the output of one pair of upsampled samples */
+		Vec2<Float> operator()(Vec2<Float>, Vec2<Float>) noexcept;
 
 	private:
-		const ImpulseResponse& ir;
-		ConvolverBuffer ringBuffer;
+		const ConvolverKernel<Float>* phase0;
+		const ConvolverKernel<Float>* phase1;
+		ConvolverHistory<Float> historyEven, historyOdd;
+		Vec2<Float> prevOdd;
+	};
+
+	/* Direct: zero-stuffing, full convolution, decimation
+	Polyphase: same filters, split into their phases
+	MinimumPhase: Polyphase with minimum phase filters, low latency
+	IIR: polyphase allpass half-bands, lowest latency, not linear phase either
+	Halfband: Polyphase with a half-band first stage, a quarter of the multiplies */
+	enum class OversamplerMode { Direct, Polyphase, MinimumPhase, IIR, Halfband, NumModes };
+
+	/* Eco: errors below 12 bit noise, automatically up to 192khz
+	Balanced: below 16 bit noise, automatically up to 384khz
+	Mastering: below 20 bit noise, automatically up to 768khz */
+	enum class OversamplerQuality { Eco, Balanced, Mastering, NumQualities };
+
+	/* what the anti-aliasing filters have to meet.
+	passband: highest frequency, that is kept, in hz
+	rippleDb: largest deviation from unity gain in the passband
+	attenuationDb: smallest attenuation in the stopband
+	maxRateUp: the automatic order adds no stage, that would upsample beyond it.
+	at host rates above half of it it doesn't oversample at all */
+	struct OversamplerTargets
+	{
+		double passband, rippleDb, attenuationDb, maxRateUp;
 	};
 
+	/* quality */
+	OversamplerTargets getOversamplerTargets(OversamplerQuality) noexcept;
+
+	/* sampleRate, quality, the highest order up to x16, that stays within the quality's maxRateUp */
+	OversamplingOrder getOversamplingOrderAuto(double, OversamplerQuality) noexcept;
+
+	/* the filters of a 2x stage, in the layouts its convolvers read.
+	they stay below the taps where partitioned fft convolution would pay off
+	(SlewOverBench's ConvolverFFT suites), so they all run in direct form.
+	immutable once designed, so any number of stages can share one */
+	template<typename Float>
+	struct OversamplerDesign
+	{
+		enum class Shape { Lowpass, Halfband };
+
+		struct Key
+		{
+			double sampleRateUp, passband, stopband, attenuationDb, rippleDb;
+			int orderMultiple;
+			Shape shape;
+			bool minimumPhase, polyphase;
+
+			bool operator<(const Key&) const noexcept;
+		};
+
+		/* key, allocates */
+		OversamplerDesign(const Key&);
+
+		// the whole filters, or their 2 phases if polyphase
+		std::array<ConvolverKernel<Float>, 2> kernelsUp, kernelsDown;
+		double latencyUp, latencyDown;
+		bool polyphase;
+	};
+
+	/* process-wide store of the designs in use, thread-safe.
+	stages asking for the same key get the same design,
+	which lives as long as any of them holds on to it */
+	template<typename Float>
+	struct OversamplerDesignCache
+	{
+		using Design = OversamplerDesign<Float>;
+		using DesignPtr = std::shared_ptr<const Design>;
+
+		/* key, returns the shared design, makes it if needed. allocates, locks */
+		static DesignPtr get(const typename Design::Key&);
+
+		/* number of designs held by stages right now */
+		static int getNumDesigns();
+
+	private:
+		static std::mutex& getMutex();
+		static std::map<typename Design::Key, std::weak_ptr<const Design>>& getDesigns();
+	};
+
+	/* one 2x up- and downsampling step of the oversampler */
+	template<typename Float>
+	struct OversamplerStage
+	{
+		using Mode = OversamplerMode;
+		using Design = OversamplerDesign<Float>;
+
+		OversamplerStage();
+
+		/* sampleRateUp, targets, stopband, orderMultiple, mode */
+		void prepare(double, const OversamplerTargets&, double, int, Mode);
+
+		/* sampleRateUp, targets, orderMultiple, mode */
+		void prepareHalfband(double, const OversamplerTargets&, int, Mode);
+
+		/* sampleRateUp, targets, switches to Mode::IIR */
+		void prepareIIR(double, const OversamplerTargets&);
+
+		/* samplesUp, samplesIn, numChannels, numSamplesIn */
+		void upsample(Float* const*, const Float* const*, int, int) noexcept;
+
+		/* samplesOut, samplesUp, numChannels, numSamplesOut */
+		void downsample(Float* const*, Float* const*, int, int) noexcept;
+
+		/* x, y0, y1, upsamples one sample. only if canFuse */
+		void upsample(Vec2<Float>, Vec2<Float>&, Vec2<Float>&) noexcept;
+
+		/* x0, x1, downsamples one pair of samples. only if canFuse */
+		Vec2<Float> downsample(Vec2<Float>, Vec2<Float>) noexcept;
+
+		/* latency of both filters in samples of the upsampled rate */
+		double getLatency() const noexcept;
+
+		/* the iir and the polyphase filters work sample by sample,
+		the zero-stuffed direct form only in blocks */
+		bool canFuse() const noexcept;
+
+	private:
+		typename OversamplerDesignCache<Float>::DesignPtr design;
+		Convolver<Float> filterUp, filterDown;
+		PolyphaseUpsampler<Float> polyUp;
+		PolyphaseDecimator<Float> polyDown;
+		HalfbandIIR<Float> iir;
+		Mode mode;
+
+		/* key, fetches the design and runs it through the structure of the mode */
+		void prepareStructure(typename Design::Key);
+	};
+
+	/* cascades 2x stages up to 16x.
+	the first stage carries the steep anti-aliasing filter,
+	the following ones only have to reject the images of the
+	passband, so their filters get shorter with each octave.
+	the order decides how many stages run, the quality's targets their filters */
+	template<typename Float>
 	struct Oversampler
 	{
-		static constexpr double LPCutoff = 20000.;
-		using OversamplerBuffer = std::array<std::array<double, BlockSize2x>, NumChannels>;
+		using Mode = OversamplerMode;
+		using Quality = OversamplerQuality;
+		static constexpr int NumStages = static_cast<int>(OversamplingOrder::NumOrders) - 1;
+		using StageBuffer = std::array<std::array<Float, BlockSize16x>, NumChannels>;
 
 		struct BufferInfo
 		{
-			double *smplsL, *smplsR;
+			Float *smplsL, *smplsR;
 			int numChannels, numSamples;
 		};
 
 		Oversampler();
 
-		/* sampleRate, enabled */
-		void prepare(const double, bool);
+		/* sampleRate, order, mode, quality */
+		void prepare(const double, OversamplingOrder, Mode, Quality);
 
 		/* samples, numChannels, numSamples */
-		BufferInfo upsample(double* const*, int, int) noexcept;
+		BufferInfo upsample(Float* const*, int, int) noexcept;
 
 		/* samplesOut, numSamples */
-		void downsample(double* const*, int) noexcept;
+		void downsample(Float* const*, int) noexcept;
+
+		/* true if oversampling is enabled and all stages can work sample by sample */
+		bool canFuse() const noexcept;
+
+		/* samples, numChannels, numSamples, process
+		upsamples, processes and downsamples one sample after the other, instead of
+		running each step over the whole block. the samples between the steps
+		don't go through the stage buffers. process turns a Vec2<Float> at
+		the upsampled rate into another one. only if canFuse */
+		template<typename Process>
+		void processFused(Float* const* samples, int numChannels, int numSamples, Process&& process) noexcept
+		{
+			numSamplesUp = numSamples << numStages;
+			auto smplsL = samples[0];
+			auto smplsR = samples[numChannels - 1];
+			for (auto s = 0; s < numSamples; ++s)
+			{
+				const auto x = Vec2<Float>::load(&smplsL[s], &smplsR[s]);
+				processFused<0>(x, process).store(&smplsL[s], &smplsR[s]);
+			}
+		}
 
 		int getLatency() const noexcept;
 
+		/* upsampling factor of the stages that run, 1 if none */
+		int getFactor() const noexcept;
+
 	private:
 		double sampleRate;
-		OversamplerBuffer bufferUp;
+		std::array<StageBuffer, NumStages> buffers;
 		BufferInfo bufferInfo;
-		ImpulseResponse irUp, irDown;
-		WHead2x wHead;
-		Convolver filterUp, filterDown;
+		std::array<OversamplerStage<Float>, NumStages> stages;
+		int numStages;
+
+		/* x, process, runs x through the stages from Stage on */
+		template<int Stage, typename Process>
+		Vec2<Float> processFused(Vec2<Float> x, Process& process) noexcept
+		{
+			if constexpr (Stage == NumStages)
+				return process(x);
+			else
+			{
+				if (Stage == numStages)
+					return process(x);
+				auto& stage = stages[Stage];
+				Vec2<Float> y0, y1;
+				stage.upsample(x, y0, y1);
+				y0 = processFused<Stage + 1>(y0, process);
+				y1 = processFused<Stage + 1>(y1, process);
+				return stage.downsample(y0, y1);
+			}
+		}
 	public:
 		double sampleRateUp;
 		int numSamplesUp;
+		OversamplingOrder order;
+		Mode mode;
+		Quality quality;
 		bool enabled;
 	};
+
+	using OversamplerF = Oversampler<float>;
+	using OversamplerD = Oversampler<double>;
 }
\ No newline at end of file
@@ -25,40 +25,49 @@ namespace dsp
 	template struct PRMInfo<float>;
 	template struct PRMInfo<double>;
 
-	template<typename Float>
-	PRM<Float>::PRM(Float startVal) :
+	template<typename Float, int Size>
+	PRM<Float, Size>::PRM(Float startVal) :
 		smooth(startVal),
 		buf(),
 		value(startVal)
 	{}
 	
-	template<typename Float>
-	void PRM<Float>::prepare(Float sampleRate, Float smoothLenMs) noexcept
+	template<typename Float, int Size>
+	void PRM<Float, Size>::prepare(Float sampleRate, Float smoothLenMs) noexcept
 	{
 		smooth.makeFromDecayInMs(smoothLenMs, sampleRate);
 	}
 
-	template<typename Float>
-	PRMInfo<Float> PRM<Float>::operator()(Float val, int numSamples) noexcept
+	template<typename Float, int Size>
+	void PRM<Float, Size>::reset(Float val) noexcept
+	{
+		value = val;
+		smooth.reset(val);
+	}
+
+	template<typename Float, int Size>
+	PRMInfo<Float> PRM<Float, Size>::operator()(Float val, int numSamples) noexcept
 	{
 		value = val;
 		bool smoothing = smooth(buf.data(), value, numSamples);
 		return { buf.data(), value, smoothing };
 	}
 
-	template<typename Float>
-	PRMInfo<Float> PRM<Float>::operator()(int numSamples) noexcept
+	template<typename Float, int Size>
+	PRMInfo<Float> PRM<Float, Size>::operator()(int numSamples) noexcept
 	{
 		bool smoothing = smooth(buf.data(), numSamples);
 		return { buf.data(), value, smoothing };
 	}
 
-	template<typename Float>
-	Float PRM<Float>::operator[](int i) const noexcept
+	template<typename Float, int Size>
+	Float PRM<Float, Size>::operator[](int i) const noexcept
 	{
 		return buf[i];
 	}
 
 	template struct PRM<float>;
 	template struct PRM<double>;
+	template struct PRM<float, BlockSize16x>;
+	template struct PRM<double, BlockSize16x>;
 }
\ No newline at end of file
@@ -22,7 +22,8 @@ namespace dsp
 	using PRMInfoF = PRMInfo<float>;
 	using PRMInfoD = PRMInfo<double>;
 	
-	template<typename Float>
+	/* Float-Type, Size: the most samples per call */
+	template<typename Float, int Size = BlockSize>
 	struct PRM
 	{
 		/* startVal */
@@ -31,6 +32,9 @@ namespace dsp
 		/* sampleRate, smoothLenMs */
 		void prepare(Float sampleRate, Float smoothLenMs) noexcept;
 
+		/* value, jumps to value without smoothing */
+		void reset(Float) noexcept;
+
 		/* value, numSamples */
 		PRMInfo<Float> operator()(Float, int) noexcept;
 
@@ -42,7 +46,7 @@ namespace dsp
 
 	protected:
 		smooth::Smooth<Float> smooth;
-		std::array<Float, BlockSize> buf;
+		std::array<Float, Size> buf;
 		Float value;
 	};
 
@@ -2,66 +2,62 @@
 
 namespace dsp
 {
-	template<size_t NumBands>
-	ParallelProcessor<NumBands>::ParallelProcessor() :
+	template<typename Float, size_t NumBands, int ChannelCount>
+	ParallelProcessor<Float, NumBands, ChannelCount>::ParallelProcessor() :
 		bands()
 	{}
 
-	template<size_t NumBands>
-	void ParallelProcessor<NumBands>::split(double* const* samples, int numChannels, int numSamples) noexcept
+	template<typename Float, size_t NumBands, int ChannelCount>
+	void ParallelProcessor<Float, NumBands, ChannelCount>::split(Float* const* samples, int numChannels, int numSamples) noexcept
 	{
 		for (auto b = 0; b < MaxBand; ++b)
-		{
-			const auto b2 = 2 * b;
-			double* band[] = { bands[b2].data(), bands[b2 + 1].data() };
-
 			for (auto ch = 0; ch < numChannels; ++ch)
-				SIMD::copy(band[ch], samples[ch], numSamples);
-		}
+				SIMD::copy(bands[b * ChannelCount + ch].data(), samples[ch], numSamples);
 	}
 
-	template<size_t NumBands>
-	void ParallelProcessor<NumBands>::join(double* const* samples, int numChannels, int numSamples) noexcept
+	template<typename Float, size_t NumBands, int ChannelCount>
+	void ParallelProcessor<Float, NumBands, ChannelCount>::join(Float* const* samples, int numChannels, int numSamples) noexcept
 	{
 		for (auto b = 0; b < MaxBand; ++b)
-		{
-			const auto b2 = 2 * b;
-			const double* band[] = { bands[b2].data(), bands[b2 + 1].data() };
-
 			for (auto ch = 0; ch < numChannels; ++ch)
-				SIMD::add(samples[ch], band[ch], numSamples);
-		}
+				SIMD::add(samples[ch], bands[b * ChannelCount + ch].data(), numSamples);
 	}
 
-	template<size_t NumBands>
-	void ParallelProcessor<NumBands>::applyGain(double gain, int bandIdx, int numChannels, int numSamples) noexcept
+	template<typename Float, size_t NumBands, int ChannelCount>
+	void ParallelProcessor<Float, NumBands, ChannelCount>::join(Float* const* samples, int numChannels, int numSamples, int numBands) noexcept
 	{
-		const auto b2 = 2 * bandIdx;
-		double* band[] = { bands[b2].data(), bands[b2 + 1].data() };
+		for (auto b = 0; b < numBands - 1; ++b)
+			for (auto ch = 0; ch < numChannels; ++ch)
+				SIMD::add(samples[ch], bands[b * ChannelCount + ch].data(), numSamples);
+	}
 
+	template<typename Float, size_t NumBands, int ChannelCount>
+	void ParallelProcessor<Float, NumBands, ChannelCount>::applyGain(Float gain, int bandIdx, int numChannels, int numSamples) noexcept
+	{
+		const auto b = bandIdx * ChannelCount;
 		for (auto ch = 0; ch < numChannels; ++ch)
-			SIMD::multiply(band[ch], gain, numSamples);
+			SIMD::multiply(bands[b + ch].data(), gain, numSamples);
 	}
 
-	template<size_t NumBands>
-	void ParallelProcessor<NumBands>::applyGain(double* gain, int bandIdx, int numChannels, int numSamples) noexcept
+	template<typename Float, size_t NumBands, int ChannelCount>
+	void ParallelProcessor<Float, NumBands, ChannelCount>::applyGain(Float* gain, int bandIdx, int numChannels, int numSamples) noexcept
 	{
-		const auto b2 = 2 * bandIdx;
-		double* band[] = { bands[b2].data(), bands[b2 + 1].data() };
-
+		const auto b = bandIdx * ChannelCount;
 		for (auto ch = 0; ch < numChannels; ++ch)
-			SIMD::multiply(band[ch], gain, numSamples);
+			SIMD::multiply(bands[b + ch].data(), gain, numSamples);
 	}
 
-	template<size_t NumBands>
-	ParallelProcessor<NumBands>::Band ParallelProcessor<NumBands>::getBand(int bandIdx) noexcept
+	template<typename Float, size_t NumBands, int ChannelCount>
+	typename ParallelProcessor<Float, NumBands, ChannelCount>::Band ParallelProcessor<Float, NumBands, ChannelCount>::getBand(int bandIdx) noexcept
 	{
-		const auto b2 = 2 * bandIdx;
-		return { bands[b2].data(), bands[b2 + 1].data() };
+		Band band;
+		for (auto ch = 0; ch < ChannelCount; ++ch)
+			band[ch] = bands[bandIdx * ChannelCount + ch].data();
+		return band;
 	}
 
-	template<size_t NumBands>
-	void ParallelProcessor<NumBands>::joinMix(double* const* samples, double* mix,
+	template<typename Float, size_t NumBands, int ChannelCount>
+	void ParallelProcessor<Float, NumBands, ChannelCount>::joinMix(Float* const* samples, Float* mix,
 		int numChannels, int numSamples) noexcept
 	{
 		for (auto ch = 0; ch < numChannels; ++ch)
@@ -74,8 +70,8 @@ namespace dsp
 		}
 	}
 
-	template<size_t NumBands>
-	void ParallelProcessor<NumBands>::joinMix(double* const* samples, double mix,
+	template<typename Float, size_t NumBands, int ChannelCount>
+	void ParallelProcessor<Float, NumBands, ChannelCount>::joinMix(Float* const* samples, Float mix,
 		int numChannels, int numSamples) noexcept
 	{
 		for (auto ch = 0; ch < numChannels; ++ch)
@@ -88,8 +84,8 @@ namespace dsp
 		}
 	}
 
-	template<size_t NumBands>
-	void ParallelProcessor<NumBands>::joinDelta(double* const* samples, double* gain,
+	template<typename Float, size_t NumBands, int ChannelCount>
+	void ParallelProcessor<Float, NumBands, ChannelCount>::joinDelta(Float* const* samples, Float* gain,
 		int numChannels, int numSamples) noexcept
 	{
 		for (auto ch = 0; ch < numChannels; ++ch)
@@ -109,8 +105,8 @@ namespace dsp
 		}
 	}
 
-	template<size_t NumBands>
-	void ParallelProcessor<NumBands>::joinDelta(double* const* samples, double gain,
+	template<typename Float, size_t NumBands, int ChannelCount>
+	void ParallelProcessor<Float, NumBands, ChannelCount>::joinDelta(Float* const* samples, Float gain,
 		int numChannels, int numSamples) noexcept
 	{
 		for (auto ch = 0; ch < numChannels; ++ch)
@@ -129,8 +125,20 @@ namespace dsp
 		}
 	}
 
-	template struct ParallelProcessor<2>;
-	template struct ParallelProcessor<3>;
-	template struct ParallelProcessor<4>;
-	template struct ParallelProcessor<5>;
+	template struct ParallelProcessor<float, 2>;
+	template struct ParallelProcessor<double, 2>;
+	template struct ParallelProcessor<float, 3>;
+	template struct ParallelProcessor<double, 3>;
+	template struct ParallelProcessor<float, 4>;
+	template struct ParallelProcessor<double, 4>;
+	template struct ParallelProcessor<float, 5>;
+	template struct ParallelProcessor<double, 5>;
+	template struct ParallelProcessor<float, 2, 2>;
+	template struct ParallelProcessor<double, 2, 2>;
+	template struct ParallelProcessor<float, 3, 2>;
+	template struct ParallelProcessor<double, 3, 2>;
+	template struct ParallelProcessor<float, 4, 2>;
+	template struct ParallelProcessor<double, 4, 2>;
+	template struct ParallelProcessor<float, 5, 2>;
+	template struct ParallelProcessor<double, 5, 2>;
 }
\ No newline at end of file
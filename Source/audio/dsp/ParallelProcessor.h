@@ -3,54 +3,60 @@
 
 namespace dsp
 {
-	template<size_t NumBands>
+	/* NumBands, the dry signal and the bands above it, ChannelCount, the most channels a band holds */
+	template<typename Float, size_t NumBands, int ChannelCount = MaxChannels>
 	struct ParallelProcessor
 	{
 		static constexpr int MaxBand = NumBands - 1;
-		static constexpr int NumChannels = 2 * MaxBand;
+		static constexpr int NumBuffers = ChannelCount * MaxBand;
 
-		struct Band
-		{
-			double* l;
-			double* r;
-		};
+		// the channels of a band
+		using Band = std::array<Float*, ChannelCount>;
 
 		ParallelProcessor();
 
-		void split(double* const*, int, int) noexcept;
+		void split(Float* const*, int, int) noexcept;
 
-		void join(double* const*, int, int) noexcept;
+		void join(Float* const*, int, int) noexcept;
+
+		/* samples, numChannels, numSamples, numBands[1, NumBands]
+		adds only the bands below numBands, the others may hold anything */
+		void join(Float* const*, int, int, int) noexcept;
 
 		/* gain, bandIdx, numChannels, numSamples */
-		void applyGain(double, int, int, int) noexcept;
+		void applyGain(Float, int, int, int) noexcept;
 
 		/* gain, bandIdx, numChannels, numSamples */
-		void applyGain(double*, int, int, int) noexcept;
+		void applyGain(Float*, int, int, int) noexcept;
 
 		Band getBand(int) noexcept;
 
 		/* only for parallel processors with exactly 2 bands
 		samples, mix, numChannels, numSamples */
-		void joinMix(double* const*, double*, int, int) noexcept;
+		void joinMix(Float* const*, Float*, int, int) noexcept;
 
 		/* only for parallel processors with exactly 2 bands
 		samples, mix, numChannels, numSamples */
-		void joinMix(double* const*, double, int, int) noexcept;
+		void joinMix(Float* const*, Float, int, int) noexcept;
 
 		/* only for parallel processors with exactly 2 bands
 		samples, gain, numChannels, numSamples */
-		void joinDelta(double* const*, double*, int, int) noexcept;
+		void joinDelta(Float* const*, Float*, int, int) noexcept;
 
 		/* only for parallel processors with exactly 2 bands
 		samples, gain, numChannels, numSamples */
-		void joinDelta(double* const*, double, int, int) noexcept;
+		void joinDelta(Float* const*, Float, int, int) noexcept;
 
 	private:
-		std::array<std::array<double, BlockSize>, NumChannels> bands;
+		std::array<std::array<Float, BlockSize>, NumBuffers> bands;
 	};
 
-	using PP2Band = ParallelProcessor<2>;
-	using PP3Band = ParallelProcessor<3>;
-	using PP4Band = ParallelProcessor<4>;
-	using PP5Band = ParallelProcessor<5>;
+	template<typename Float>
+	using PP2Band = ParallelProcessor<Float, 2>;
+	template<typename Float>
+	using PP3Band = ParallelProcessor<Float, 3>;
+	template<typename Float>
+	using PP4Band = ParallelProcessor<Float, 4>;
+	template<typename Float>
+	using PP5Band = ParallelProcessor<Float, 5>;
 }
\ No newline at end of file
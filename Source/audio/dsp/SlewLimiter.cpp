@@ -2,50 +2,221 @@
 
 namespace dsp
 {
-    SlewLimiter::SlewLimiter() :
-        y(0.),
-        dist(0.),
-        filterTypeFuncs()
+    template<typename Float>
+    SlewLimiter<Float>::SlewLimiter() :
+        y(),
+        yBand()
     {
-        filterTypeFuncs[LP] = [&x = y]()
-        {
-            return x;
-        };
-        filterTypeFuncs[HP] = [&x = dist]()
+    }
+
+    template<typename Float>
+    void SlewLimiter<Float>::operator()(Float* smpls, Float rise, Float fall,
+        int numSamples, Type type) noexcept
+    {
+        switch (type)
         {
-            return x;
-        };
+        case HP: return process<HP>(smpls, rise, fall, numSamples);
+        case BP: return process<BP>(smpls, rise, fall, numSamples);
+        default: return process<LP>(smpls, rise, fall, numSamples);
+        }
     }
 
-    void SlewLimiter::operator()(double* smpls, double slew,
+    template<typename Float>
+    void SlewLimiter<Float>::operator()(Float* smpls, const Float* rise, const Float* fall,
         int numSamples, Type type) noexcept
     {
+        switch (type)
+        {
+        case HP: return process<HP>(smpls, rise, fall, numSamples);
+        case BP: return process<BP>(smpls, rise, fall, numSamples);
+        default: return process<LP>(smpls, rise, fall, numSamples);
+        }
+    }
+
+    template<typename Float>
+    template<typename SlewLimiter<Float>::Type FilterType>
+    void SlewLimiter<Float>::process(Float* smpls, Float rise, Float fall, int numSamples) noexcept
+    {
+        auto _y = y;
+        auto _yBand = yBand;
         for (auto s = 0; s < numSamples; ++s)
-            smpls[s] = process(smpls[s], slew, type);
+            smpls[s] = process<FilterType, 1>(smpls[s], _y, _yBand, rise, fall);
+        y = _y;
+        yBand = _yBand;
     }
 
-    double SlewLimiter::process(double x, double slew, Type type) noexcept
+    template<typename Float>
+    template<typename SlewLimiter<Float>::Type FilterType>
+    void SlewLimiter<Float>::process(Float* smpls, const Float* rise, const Float* fall, int numSamples) noexcept
     {
-        dist = x - y;
-        const auto pol = dist < 0. ? -1. : 1.;
-        y += dist * pol > slew ? slew * pol : dist;
-        return filterTypeFuncs[type]();
+        auto _y = y;
+        auto _yBand = yBand;
+        for (auto s = 0; s < numSamples; ++s)
+            smpls[s] = process<FilterType, 1>(smpls[s], _y, _yBand, rise[s], fall[s]);
+        y = _y;
+        yBand = _yBand;
     }
 
-    double SlewLimiterStereo::freqHzToSlewRate(double freq, double sampleRate) noexcept
+    template struct SlewLimiter<float>;
+    template struct SlewLimiter<double>;
+
+    template<typename Float>
+    Float SlewLimiterStereo<Float>::freqHzToSlewRate(Float freq, Float sampleRate) noexcept
     {
         return freq / sampleRate;
     }
 
-    SlewLimiterStereo::SlewLimiterStereo() :
-        slews(),
-        sampleRate(1.)
-    {}
+    template<typename Float>
+    SlewLimiterStereo<Float>::SlewLimiterStereo() :
+        y(),
+        yBand(),
+        sampleRate(static_cast<Float>(1)),
+        order(1),
+        type(SlewLimiter<Float>::LP),
+        fadeFrom(),
+        fadePhase(static_cast<Float>(1)),
+        fadeInc(static_cast<Float>(1))
+    {
+        y.fill(Vec2<Float>::fill(static_cast<Float>(0)));
+        yBand.fill(Vec2<Float>::fill(static_cast<Float>(0)));
+        fadeFrom[SlewLimiter<Float>::LP] = static_cast<Float>(1);
+    }
+
+    template<typename Float>
+    void SlewLimiterStereo<Float>::prepare(Float _sampleRate) noexcept
+    {
+        sampleRate = _sampleRate;
+        const auto fadeLength = CrossfadeMs * static_cast<Float>(.001) * sampleRate;
+        fadeInc = static_cast<Float>(1) / std::max(fadeLength, static_cast<Float>(1));
+    }
+
+    template<typename Float>
+    void SlewLimiterStereo<Float>::copyState(const SlewLimiterStereo& other) noexcept
+    {
+        y = other.y;
+        yBand = other.yBand;
+        order = other.order;
+        type = other.type;
+        fadeFrom = other.fadeFrom;
+        fadePhase = other.fadePhase;
+    }
+
+    template<typename Float>
+    void SlewLimiterStereo<Float>::reset() noexcept
+    {
+        y.fill(Vec2<Float>::fill(static_cast<Float>(0)));
+        yBand.fill(Vec2<Float>::fill(static_cast<Float>(0)));
+    }
+
+    template<typename Float>
+    void SlewLimiterStereo<Float>::setOrder(int _order) noexcept
+    {
+        for (auto o = order; o < _order; ++o)
+        {
+            y[o] = y[order - 1];
+            yBand[o] = yBand[order - 1];
+        }
+        order = _order;
+    }
+
+    template<typename Float>
+    void SlewLimiterStereo<Float>::setType(Type _type) noexcept
+    {
+        if (_type == type)
+            return;
+        const auto weights = getWeights();
+        // a silent BP catches up with the main cascade, so that it fades in from 0
+        if (weights[SlewLimiter<Float>::BP] == static_cast<Float>(0))
+            yBand = y;
+        fadeFrom = weights;
+        type = _type;
+        fadePhase = static_cast<Float>(0);
+    }
+
+    template<typename Float>
+    std::array<Float, SlewLimiterStereo<Float>::NumTypes> SlewLimiterStereo<Float>::getWeights() const noexcept
+    {
+        std::array<Float, NumTypes> weights;
+        for (auto t = 0; t < NumTypes; ++t)
+        {
+            const auto to = static_cast<Float>(t == type ? 1 : 0);
+            weights[t] = fadeFrom[t] + (to - fadeFrom[t]) * fadePhase;
+        }
+        return weights;
+    }
+
+    template<typename Float>
+    typename SlewLimiterStereo<Float>::Type SlewLimiterStereo<Float>::getKernelType() const noexcept
+    {
+        return fadePhase < static_cast<Float>(1) ? SlewLimiter<Float>::NumTypes : type;
+    }
 
-    void SlewLimiterStereo::operator()(double** samples, double slew,
-        int numChannels, int numSamples, Type type) noexcept
+    template<typename Float>
+    void SlewLimiterStereo<Float>::operator()(Float* const* samples, Float rise, Float fall,
+        int numChannels, int numSamples, Type _type, int _order) noexcept
     {
-        for (auto ch = 0; ch < numChannels; ++ch)
-            slews[ch](samples[ch], slew, numSamples, type);
+        setOrder(_order);
+        setType(_type);
+        dispatch(getKernelType(), order, [&]<Type FilterType, int Order>()
+        {
+            process<FilterType, Order>(samples, rise, fall, numChannels, numSamples);
+        });
+    }
+
+    template<typename Float>
+    void SlewLimiterStereo<Float>::operator()(Float* const* samples, const Float* rise, const Float* fall,
+        int numChannels, int numSamples, Type _type, int _order) noexcept
+    {
+        setOrder(_order);
+        setType(_type);
+        dispatch(getKernelType(), order, [&]<Type FilterType, int Order>()
+        {
+            process<FilterType, Order>(samples, rise, fall, numChannels, numSamples);
+        });
     }
+
+    template<typename Float>
+    template<typename SlewLimiterStereo<Float>::Type FilterType, int Order>
+    void SlewLimiterStereo<Float>::process(Float* const* samples, Float rise, Float fall,
+        int numChannels, int numSamples) noexcept
+    {
+        auto smplsL = samples[0];
+        // mono runs the same kernel with the left lane duplicated into the right one
+        const auto stereo = numChannels == 2;
+        auto smplsR = stereo ? samples[1] : samples[0];
+
+        const auto riseV = Vec2<Float>::fill(rise);
+        const auto fallV = Vec2<Float>::fill(fall);
+        auto regs = loadState<Order>();
+        for (auto s = 0; s < numSamples; ++s)
+        {
+            const auto x = Vec2<Float>::load(&smplsL[s], &smplsR[s]);
+            const auto out = processSample<FilterType, Order>(x, regs, riseV, fallV);
+            out.store(&smplsL[s], &smplsR[s]);
+        }
+        storeState<Order>(regs);
+    }
+
+    template<typename Float>
+    template<typename SlewLimiterStereo<Float>::Type FilterType, int Order>
+    void SlewLimiterStereo<Float>::process(Float* const* samples, const Float* rise, const Float* fall,
+        int numChannels, int numSamples) noexcept
+    {
+        auto smplsL = samples[0];
+        const auto stereo = numChannels == 2;
+        auto smplsR = stereo ? samples[1] : samples[0];
+
+        auto regs = loadState<Order>();
+        for (auto s = 0; s < numSamples; ++s)
+        {
+            const auto x = Vec2<Float>::load(&smplsL[s], &smplsR[s]);
+            const auto out = processSample<FilterType, Order>(x, regs,
+                Vec2<Float>::fill(rise[s]), Vec2<Float>::fill(fall[s]));
+            out.store(&smplsL[s], &smplsR[s]);
+        }
+        storeState<Order>(regs);
+    }
+
+    template struct SlewLimiterStereo<float>;
+    template struct SlewLimiterStereo<double>;
 }
\ No newline at end of file
@@ -1,42 +1,359 @@
 #pragma once
-#include "../Using.h"
+#include "Vec2.h"
 
 namespace dsp
 {
+    template<typename Float>
 	struct SlewLimiter
 	{
-        enum Type { LP, HP, NumTypes };
-        using FilerTypeFunc = std::function<double()>;
-        using FilterTypeFuncs = std::array<FilerTypeFunc, NumTypes>;
-       
+        enum Type { LP, HP, BP, NumTypes };
+        // the most stages of the cascade
+        static constexpr int MaxOrder = 8;
+        // BP is the difference of two cascades, one this many times faster than the other
+        static constexpr Float BandRatio = static_cast<Float>(4);
+
         SlewLimiter();
 
-        /* smpls, slew[0,2], numSamples, type */
-        void operator()(double* smpls, double slew,
+        /* smpls, rise[0,2], fall[0,2], numSamples, type */
+        void operator()(Float* smpls, Float rise, Float fall,
+            int numSamples, Type type) noexcept;
+
+        /* smpls, rise[0,2] and fall[0,2] of each sample, numSamples, type */
+        void operator()(Float* smpls, const Float* rise, const Float* fall,
             int numSamples, Type type) noexcept;
 
+        /* x, y, rise, fall
+        branchless: y moves towards x by at most rise upwards and by at most fall downwards.
+        the clamp to [-fall, rise] picks each lane's rate by the sign of its distance,
+        which is the mask blend without the mask. returns y for LP and the distance to x for HP */
+        template<Type FilterType, typename Value>
+        static Value process(Value x, Value& y, Value rise, Value fall) noexcept
+        {
+            const auto dist = x - y;
+            y = y + max(min(dist, rise), Value() - fall);
+            if constexpr (FilterType == LP)
+                return y;
+            else
+                return dist;
+        }
+
+        /* x, y of each stage, rise, fall
+        Order stages in series within the same sample, each one filters the output of the one before.
+        hard slew limiters in series would just repeat the first one's ramp, so from order 2 on every stage
+        has a soft knee, see processSoft. the stages unroll, so that y stays in registers if the caller keeps it local.
+        returns the last stage's output for LP and the distance of x to it for HP */
+        template<Type FilterType, int Order, typename Value>
+        static Value process(Value x, std::array<Value, Order>& y, Value rise, Value fall) noexcept
+        {
+            if constexpr (Order == 1)
+                return process<FilterType>(x, y[0], rise, fall);
+            else
+            {
+                const auto dist = x - y[Order - 1];
+                const auto rateMax = fill<Value>(Knee);
+                const auto toGain = fill<Value>(static_cast<Float>(1) / Knee);
+                rise = min(rise, rateMax);
+                fall = min(fall, rateMax);
+                x = processStages<0, Order>(x, y, rise, fall, rise * toGain, fall * toGain);
+                if constexpr (FilterType == LP)
+                    return x;
+                else
+                    return dist;
+            }
+        }
+
+        /* x, y of each stage, yBand of each stage, rise, fall
+        like above, but also does BP, which needs the faster cascade yBand */
+        template<Type FilterType, int Order, typename Value>
+        static Value process(Value x, std::array<Value, Order>& y, std::array<Value, Order>& yBand,
+            Value rise, Value fall) noexcept
+        {
+            if constexpr (FilterType == BP)
+            {
+                const auto ratio = fill<Value>(BandRatio);
+                const auto lp = process<LP, Order>(x, y, rise, fall);
+                return process<LP, Order>(x, yBand, rise * ratio, fall * ratio) - lp;
+            }
+            else
+                return process<FilterType, Order>(x, y, rise, fall);
+        }
+
+        /* x, y of each stage, yBand of each stage, rise, fall, weight of each type
+        all types in one pass, mixed by weight */
+        template<int Order, typename Value>
+        static Value processMix(Value x, std::array<Value, Order>& y, std::array<Value, Order>& yBand,
+            Value rise, Value fall, const std::array<Value, NumTypes>& weights) noexcept
+        {
+            const auto ratio = fill<Value>(BandRatio);
+            const auto hp = x - y[Order - 1];
+            const auto lp = process<LP, Order>(x, y, rise, fall);
+            const auto bp = process<LP, Order>(x, yBand, rise * ratio, fall * ratio) - lp;
+            return lp * weights[LP] + hp * weights[HP] + bp * weights[BP];
+        }
+
+        /* x, y, rise[0,Knee], fall[0,Knee], riseGain, fallGain (rise and fall over Knee)
+        a one-pole lowpass at the slew rate's frequency while y is closer to x than Knee,
+        which slews at rise upwards and fall downwards from there on. returns y */
+        template<typename Value>
+        static forcedinline Value processSoft(Value x, Value& y, Value rise, Value fall, Value riseGain, Value fallGain) noexcept
+        {
+            const auto dist = x - y;
+            const auto up = min(max(dist, Value()) * riseGain, rise);
+            const auto down = max(min(dist, Value()) * fallGain, Value() - fall);
+            y = y + up + down;
+            return y;
+        }
+
     protected:
-        double y, dist;
-        FilterTypeFuncs filterTypeFuncs;
+        std::array<Float, 1> y, yBand;
+
+        // distance of the soft stages' knee. rates above it would overshoot
+        static constexpr Float Knee = static_cast<Float>(.15915494309189535);
 
-        /* x, slew, type */
-        double process(double, double, Type) noexcept;
+        /* x */
+        template<typename Value>
+        static Value fill(Float x) noexcept
+        {
+            if constexpr (std::is_floating_point_v<Value>)
+                return x;
+            else
+                return Value::fill(x);
+        }
+
+        /* x, y of each stage, rise, fall, riseGain, fallGain
+        unrolled at compile time and forced inline, otherwise y would go through memory from about 8 stages on */
+        template<int Stage, int Order, typename Value>
+        static forcedinline Value processStages(Value x, std::array<Value, Order>& y, Value rise, Value fall,
+            Value riseGain, Value fallGain) noexcept
+        {
+            x = processSoft(x, y[Stage], rise, fall, riseGain, fallGain);
+            if constexpr (Stage + 1 < Order)
+                return processStages<Stage + 1, Order>(x, y, rise, fall, riseGain, fallGain);
+            else
+                return x;
+        }
+
+        /* smpls, rise, fall, numSamples */
+        template<Type FilterType>
+        void process(Float*, Float, Float, int) noexcept;
+
+        /* smpls, rise and fall of each sample, numSamples */
+        template<Type FilterType>
+        void process(Float*, const Float*, const Float*, int) noexcept;
 	};
 
+    template<typename Float>
     struct SlewLimiterStereo
     {
-        using Type = SlewLimiter::Type;
+        using Type = typename SlewLimiter<Float>::Type;
+        static constexpr int MaxOrder = SlewLimiter<Float>::MaxOrder;
+        static constexpr int NumTypes = SlewLimiter<Float>::NumTypes;
+        // changes of the filter type crossfade between the types' outputs
+        static constexpr Float CrossfadeMs = static_cast<Float>(20);
 
         /* freq, sampleRate */
-        static double freqHzToSlewRate(double, double) noexcept;
+        static Float freqHzToSlewRate(Float, Float) noexcept;
 
         SlewLimiterStereo();
 
-        /* samples, slewRate[0,2], numChannels, numSamples, filterType */
-        void operator()(double**, double, int, int, Type) noexcept;
+        /* sampleRate, the rate it runs at */
+        void prepare(Float) noexcept;
+
+        /* other, takes over its output but keeps the own sample rate */
+        void copyState(const SlewLimiterStereo&) noexcept;
+
+        /* clears the output, like when a band joins in silent */
+        void reset() noexcept;
+
+        /* samples, rise[0,2], fall[0,2], numChannels, numSamples, filterType, order[1,MaxOrder] */
+        void operator()(Float* const*, Float, Float, int, int, Type, int) noexcept;
+
+        /* samples, rise[0,2] and fall[0,2] of each sample, numChannels, numSamples, filterType, order[1,MaxOrder]
+        for modulated slew rates, like a parameter while it is smoothing */
+        void operator()(Float* const*, const Float*, const Float*, int, int, Type, int) noexcept;
+
+        /* oversampler, samples, rise[0,2], fall[0,2], numChannels, numSamples, filterType, order[1,MaxOrder]
+        slew limits at the oversampler's rate within its fused loop, see Oversampler::processFused */
+        template<typename Oversampler>
+        void operator()(Oversampler& oversampler, Float* const* samples, Float rise, Float fall,
+            int numChannels, int numSamples, Type _type, int _order) noexcept
+        {
+            setOrder(_order);
+            setType(_type);
+            dispatch(getKernelType(), order, [&]<Type FilterType, int Order>()
+            {
+                process<FilterType, Order>(oversampler, samples, rise, fall, numChannels, numSamples);
+            });
+        }
+
+        /* oversampler, samples, rise[0,2] and fall[0,2] of each sample at the oversampled rate, numChannels, numSamples, filterType, order[1,MaxOrder]
+        numSamples is at the host's rate, rise and fall have numSamples times the oversampler's factor values */
+        template<typename Oversampler>
+        void operator()(Oversampler& oversampler, Float* const* samples, const Float* rise, const Float* fall,
+            int numChannels, int numSamples, Type _type, int _order) noexcept
+        {
+            setOrder(_order);
+            setType(_type);
+            dispatch(getKernelType(), order, [&]<Type FilterType, int Order>()
+            {
+                process<FilterType, Order>(oversampler, samples, rise, fall, numChannels, numSamples);
+            });
+        }
 
     protected:
-        std::array<SlewLimiter, 2> slews;
-        double sampleRate;
+        // output of each stage, of the main and of the faster cascade of BP
+        std::array<Vec2<Float>, MaxOrder> y, yBand;
+        Float sampleRate;
+        int order;
+        // the crossfade runs from the weights fadeFrom to type's output
+        Type type;
+        std::array<Float, NumTypes> fadeFrom;
+        Float fadePhase, fadeInc;
+
+        /* what the kernels keep in registers, for Order stages */
+        template<int Order>
+        struct Registers
+        {
+            std::array<Vec2<Float>, Order> y, yBand;
+            std::array<Vec2<Float>, NumTypes> from, delta;
+            Vec2<Float> phase, inc;
+        };
+
+        /* order, stages that join in start at the last one's output, so that the output doesn't jump */
+        void setOrder(int) noexcept;
+
+        /* type, starts a crossfade to it if it is new */
+        void setType(Type) noexcept;
+
+        /* the weight of each type at the current fade phase */
+        std::array<Float, NumTypes> getWeights() const noexcept;
+
+        /* type, or NumTypes while crossfading */
+        Type getKernelType() const noexcept;
+
+        /* type, order, kernel
+        calls kernel.operator()<FilterType, Order>(), one pre-instantiated kernel per type and order.
+        FilterType NumTypes is the crossfade */
+        template<typename Kernel>
+        static void dispatch(Type type, int order, Kernel&& kernel) noexcept
+        {
+            switch (type)
+            {
+            case SlewLimiter<Float>::HP: return dispatch<SlewLimiter<Float>::HP>(order, kernel);
+            case SlewLimiter<Float>::BP: return dispatch<SlewLimiter<Float>::BP>(order, kernel);
+            case SlewLimiter<Float>::NumTypes: return dispatch<SlewLimiter<Float>::NumTypes>(order, kernel);
+            default: return dispatch<SlewLimiter<Float>::LP>(order, kernel);
+            }
+        }
+
+        /* order, kernel */
+        template<Type FilterType, typename Kernel>
+        static void dispatch(int order, Kernel& kernel) noexcept
+        {
+            switch (order)
+            {
+            case 2: return kernel.template operator()<FilterType, 2>();
+            case 3: return kernel.template operator()<FilterType, 3>();
+            case 4: return kernel.template operator()<FilterType, 4>();
+            case 5: return kernel.template operator()<FilterType, 5>();
+            case 6: return kernel.template operator()<FilterType, 6>();
+            case 7: return kernel.template operator()<FilterType, 7>();
+            case 8: return kernel.template operator()<FilterType, 8>();
+            default: return kernel.template operator()<FilterType, 1>();
+            }
+        }
+
+        /* copies the state of the first Order stages and the crossfade into registers and back */
+        template<int Order>
+        Registers<Order> loadState() const noexcept
+        {
+            Registers<Order> regs;
+            for (auto o = 0; o < Order; ++o)
+            {
+                regs.y[o] = y[o];
+                regs.yBand[o] = yBand[o];
+            }
+            for (auto t = 0; t < NumTypes; ++t)
+            {
+                const auto to = static_cast<Float>(t == type ? 1 : 0);
+                regs.from[t] = Vec2<Float>::fill(fadeFrom[t]);
+                regs.delta[t] = Vec2<Float>::fill(to - fadeFrom[t]);
+            }
+            regs.phase = Vec2<Float>::fill(fadePhase);
+            regs.inc = Vec2<Float>::fill(fadeInc);
+            return regs;
+        }
+
+        template<int Order>
+        void storeState(const Registers<Order>& regs) noexcept
+        {
+            for (auto o = 0; o < Order; ++o)
+            {
+                y[o] = regs.y[o];
+                yBand[o] = regs.yBand[o];
+            }
+            fadePhase = regs.phase.getL();
+        }
+
+        /* x, regs, rise, fall
+        the kernel of FilterType, or the crossfade of all types for NumTypes */
+        template<Type FilterType, int Order>
+        static Vec2<Float> processSample(Vec2<Float> x, Registers<Order>& regs,
+            Vec2<Float> rise, Vec2<Float> fall) noexcept
+        {
+            if constexpr (FilterType == SlewLimiter<Float>::NumTypes)
+            {
+                regs.phase = min(regs.phase + regs.inc, Vec2<Float>::fill(static_cast<Float>(1)));
+                std::array<Vec2<Float>, NumTypes> weights;
+                for (auto t = 0; t < NumTypes; ++t)
+                    weights[t] = regs.from[t] + regs.delta[t] * regs.phase;
+                return SlewLimiter<Float>::template processMix<Order>(x, regs.y, regs.yBand, rise, fall, weights);
+            }
+            else
+                return SlewLimiter<Float>::template process<FilterType, Order>(x, regs.y, regs.yBand, rise, fall);
+        }
+
+        /* samples, rise, fall, numChannels, numSamples */
+        template<Type FilterType, int Order>
+        void process(Float* const*, Float, Float, int, int) noexcept;
+
+        /* samples, rise and fall of each sample, numChannels, numSamples */
+        template<Type FilterType, int Order>
+        void process(Float* const*, const Float*, const Float*, int, int) noexcept;
+
+        /* oversampler, samples, rise, fall, numChannels, numSamples */
+        template<Type FilterType, int Order, typename Oversampler>
+        void process(Oversampler& oversampler, Float* const* samples, Float rise, Float fall,
+            int numChannels, int numSamples) noexcept
+        {
+            const auto riseV = Vec2<Float>::fill(rise);
+            const auto fallV = Vec2<Float>::fill(fall);
+            auto regs = loadState<Order>();
+            oversampler.processFused(samples, numChannels, numSamples, [&](Vec2<Float> x)
+            {
+                return processSample<FilterType, Order>(x, regs, riseV, fallV);
+            });
+            storeState<Order>(regs);
+        }
+
+        /* oversampler, samples, rise and fall of each oversampled sample, numChannels, numSamples */
+        template<Type FilterType, int Order, typename Oversampler>
+        void process(Oversampler& oversampler, Float* const* samples, const Float* rise, const Float* fall,
+            int numChannels, int numSamples) noexcept
+        {
+            auto regs = loadState<Order>();
+            auto i = 0;
+            oversampler.processFused(samples, numChannels, numSamples, [&](Vec2<Float> x)
+            {
+                const auto riseV = Vec2<Float>::fill(rise[i]);
+                const auto fallV = Vec2<Float>::fill(fall[i]);
+                ++i;
+                return processSample<FilterType, Order>(x, regs, riseV, fallV);
+            });
+            storeState<Order>(regs);
+        }
     };
+
+    using SlewLimiterStereoF = SlewLimiterStereo<float>;
+    using SlewLimiterStereoD = SlewLimiterStereo<double>;
 }
\ No newline at end of file
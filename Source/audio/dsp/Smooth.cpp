@@ -187,6 +187,15 @@ namespace dsp
 		{
 		}
 
+		template<typename Float>
+		void Smooth<Float>::reset(Float val) noexcept
+		{
+			block.curVal = val;
+			lowpass.y1 = val;
+			cur = dest = val;
+			smoothing = false;
+		}
+
 		template<typename Float>
 		bool Smooth<Float>::operator()(Float* bufferOut, Float _dest, int numSamples) noexcept
 		{
@@ -84,6 +84,9 @@ namespace dsp
 
 			Smooth(Float /*startVal*/ = static_cast<Float>(0));
 
+			/* val, jumps to val and stops smoothing */
+			void reset(Float) noexcept;
+
 			void operator=(Smooth<Float>& other) noexcept
 			{
 				block.curVal = other.block.curVal;
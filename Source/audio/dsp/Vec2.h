@@ -0,0 +1,174 @@
+#pragma once
+#include "../Using.h"
+#if JUCE_USE_SSE_INTRINSICS
+#include <emmintrin.h>
+#endif
+
+namespace dsp
+{
+	/* scalar counterparts of the lane-wise min and max,
+	same operand order as minpd/maxpd */
+	template<typename Float, std::enable_if_t<std::is_floating_point_v<Float>, bool> = true>
+	inline Float min(Float a, Float b) noexcept
+	{
+		return a < b ? a : b;
+	}
+
+	template<typename Float, std::enable_if_t<std::is_floating_point_v<Float>, bool> = true>
+	inline Float max(Float a, Float b) noexcept
+	{
+		return a > b ? a : b;
+	}
+
+	/* two lanes of Float, one per channel of a stereo pair.
+	loads and stores go through separate channel pointers,
+	so the planar buffers of the audio thread can be used directly */
+	template<typename Float>
+	struct Vec2
+	{
+		/* l, r */
+		static Vec2 load(const Float* l, const Float* r) noexcept
+		{
+			return { *l, *r };
+		}
+
+		static Vec2 fill(Float x) noexcept
+		{
+			return { x, x };
+		}
+
+		/* l, r */
+		void store(Float* _l, Float* _r) const noexcept
+		{
+			*_l = l;
+			*_r = r;
+		}
+
+		Float getL() const noexcept { return l; }
+		Float getR() const noexcept { return r; }
+
+		friend Vec2 operator+(Vec2 a, Vec2 b) noexcept { return { a.l + b.l, a.r + b.r }; }
+		friend Vec2 operator-(Vec2 a, Vec2 b) noexcept { return { a.l - b.l, a.r - b.r }; }
+		friend Vec2 operator*(Vec2 a, Vec2 b) noexcept { return { a.l * b.l, a.r * b.r }; }
+		friend Vec2 min(Vec2 a, Vec2 b) noexcept { return { a.l < b.l ? a.l : b.l, a.r < b.r ? a.r : b.r }; }
+		friend Vec2 max(Vec2 a, Vec2 b) noexcept { return { a.l > b.l ? a.l : b.l, a.r > b.r ? a.r : b.r }; }
+
+		Float l, r;
+	};
+
+	/* two Vec2 side by side, like the lowpass and highpass of a split.
+	for float they share one __m128, otherwise it's a Vec2 each */
+	template<typename Float>
+	struct Vec2x2
+	{
+		/* lo, hi */
+		static Vec2x2 join(Vec2<Float> _lo, Vec2<Float> _hi) noexcept
+		{
+			return { _lo, _hi };
+		}
+
+		/* lo, hi, each fills both lanes of its Vec2 */
+		static Vec2x2 fill(Float _lo, Float _hi) noexcept
+		{
+			return { Vec2<Float>::fill(_lo), Vec2<Float>::fill(_hi) };
+		}
+
+		Vec2<Float> getLo() const noexcept { return lo; }
+		Vec2<Float> getHi() const noexcept { return hi; }
+
+		friend Vec2x2 operator+(Vec2x2 a, Vec2x2 b) noexcept { return { a.lo + b.lo, a.hi + b.hi }; }
+		friend Vec2x2 operator-(Vec2x2 a, Vec2x2 b) noexcept { return { a.lo - b.lo, a.hi - b.hi }; }
+		friend Vec2x2 operator*(Vec2x2 a, Vec2x2 b) noexcept { return { a.lo * b.lo, a.hi * b.hi }; }
+
+		Vec2<Float> lo, hi;
+	};
+
+#if JUCE_USE_SSE_INTRINSICS
+	template<>
+	struct Vec2<double>
+	{
+		static Vec2 load(const double* l, const double* r) noexcept
+		{
+			return { _mm_loadh_pd(_mm_load_sd(l), r) };
+		}
+
+		static Vec2 fill(double x) noexcept
+		{
+			return { _mm_set1_pd(x) };
+		}
+
+		void store(double* l, double* r) const noexcept
+		{
+			_mm_storel_pd(l, v);
+			_mm_storeh_pd(r, v);
+		}
+
+		double getL() const noexcept { return _mm_cvtsd_f64(v); }
+		double getR() const noexcept { return _mm_cvtsd_f64(_mm_unpackhi_pd(v, v)); }
+
+		friend Vec2 operator+(Vec2 a, Vec2 b) noexcept { return { _mm_add_pd(a.v, b.v) }; }
+		friend Vec2 operator-(Vec2 a, Vec2 b) noexcept { return { _mm_sub_pd(a.v, b.v) }; }
+		friend Vec2 operator*(Vec2 a, Vec2 b) noexcept { return { _mm_mul_pd(a.v, b.v) }; }
+		friend Vec2 min(Vec2 a, Vec2 b) noexcept { return { _mm_min_pd(a.v, b.v) }; }
+		friend Vec2 max(Vec2 a, Vec2 b) noexcept { return { _mm_max_pd(a.v, b.v) }; }
+
+		__m128d v;
+	};
+
+	// float lanes live in the lower half of a __m128
+	template<>
+	struct Vec2<float>
+	{
+		static Vec2 load(const float* l, const float* r) noexcept
+		{
+			return { _mm_unpacklo_ps(_mm_load_ss(l), _mm_load_ss(r)) };
+		}
+
+		static Vec2 fill(float x) noexcept
+		{
+			return { _mm_set1_ps(x) };
+		}
+
+		void store(float* l, float* r) const noexcept
+		{
+			_mm_store_ss(l, v);
+			_mm_store_ss(r, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+		}
+
+		float getL() const noexcept { return _mm_cvtss_f32(v); }
+		float getR() const noexcept { return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))); }
+
+		friend Vec2 operator+(Vec2 a, Vec2 b) noexcept { return { _mm_add_ps(a.v, b.v) }; }
+		friend Vec2 operator-(Vec2 a, Vec2 b) noexcept { return { _mm_sub_ps(a.v, b.v) }; }
+		friend Vec2 operator*(Vec2 a, Vec2 b) noexcept { return { _mm_mul_ps(a.v, b.v) }; }
+		friend Vec2 min(Vec2 a, Vec2 b) noexcept { return { _mm_min_ps(a.v, b.v) }; }
+		friend Vec2 max(Vec2 a, Vec2 b) noexcept { return { _mm_max_ps(a.v, b.v) }; }
+
+		__m128 v;
+	};
+
+	// the upper half of the __m128 holds hi
+	template<>
+	struct Vec2x2<float>
+	{
+		static Vec2x2 join(Vec2<float> lo, Vec2<float> hi) noexcept
+		{
+			return { _mm_movelh_ps(lo.v, hi.v) };
+		}
+
+		static Vec2x2 fill(float lo, float hi) noexcept
+		{
+			return { _mm_setr_ps(lo, lo, hi, hi) };
+		}
+
+		Vec2<float> getLo() const noexcept { return { v }; }
+		Vec2<float> getHi() const noexcept { return { _mm_movehl_ps(v, v) }; }
+
+		friend Vec2x2 operator+(Vec2x2 a, Vec2x2 b) noexcept { return { _mm_add_ps(a.v, b.v) }; }
+		friend Vec2x2 operator-(Vec2x2 a, Vec2x2 b) noexcept { return { _mm_sub_ps(a.v, b.v) }; }
+		friend Vec2x2 operator*(Vec2x2 a, Vec2x2 b) noexcept { return { _mm_mul_ps(a.v, b.v) }; }
+
+		__m128 v;
+	};
+#endif
+}
@@ -59,4 +59,6 @@ namespace dsp
 	template struct WHead<BlockSize>;
 	template struct WHead<BlockSize2x>;
 	template struct WHead<BlockSize4x>;
+	template struct WHead<BlockSize8x>;
+	template struct WHead<BlockSize16x>;
 }
\ No newline at end of file
@@ -30,4 +30,6 @@ namespace dsp
 	using WHead1x = WHead<BlockSize>;
 	using WHead2x = WHead<BlockSize2x>;
 	using WHead4x = WHead<BlockSize4x>;
+	using WHead8x = WHead<BlockSize8x>;
+	using WHead16x = WHead<BlockSize16x>;
 }
\ No newline at end of file
@@ -20,6 +20,11 @@ namespace dsp
 
 		for (const auto it : midiMessages)
 		{
+			if (!isNoteOnOrOff(it.data))
+			{
+				buffer.addEvent(it.data, it.numBytes, it.samplePosition);
+				continue;
+			}
 			auto msg = it.getMessage();
 
 			if (msg.isNoteOn())
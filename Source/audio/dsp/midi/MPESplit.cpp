@@ -13,9 +13,8 @@ namespace dsp
 
 		for (const auto midi : midiIn)
 		{
-			const auto msg = midi.getMessage();
-			const auto ch = msg.getChannel();
-			buffers[ch].addEvent(msg, midi.samplePosition);
+			const auto ch = getMIDIChannel(midi.data);
+			buffers[ch].addEvent(midi.data, midi.numBytes, midi.samplePosition);
 		}
 
 		midiIn.swapWith(buffers[Sysex]);
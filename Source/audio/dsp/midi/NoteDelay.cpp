@@ -20,17 +20,19 @@ namespace dsp
 
 		for (const auto it : midi)
 		{
-			const auto msg = it.getMessage();
 			const auto ts = it.samplePosition;
-			if (msg.isNoteOnOrOff())
+			if (isNoteOnOrOff(it.data))
 			{
 				if (ts < numSamples)
-					buffer.addEvent(msg, ts + 1);
+					buffer.addEvent(it.data, it.numBytes, ts + 1);
 				else
-					temp = msg;
+				{
+					temp = it.getMessage();
+					needTemp = true;
+				}
 			}
 			else
-				buffer.addEvent(msg, ts);
+				buffer.addEvent(it.data, it.numBytes, ts);
 		}
 
 		midi.swapWith(buffer);
@@ -61,12 +63,11 @@ namespace dsp
 
 		for (const auto it : midi)
 		{
-			const auto msg = it.getMessage();
 			const auto ts = it.samplePosition;
-			if (msg.isNoteOnOrOff())
-				addToStack(msg, ts + delayLength);
+			if (isNoteOnOrOff(it.data))
+				addToStack(it.getMessage(), ts + delayLength);
 			else
-				buffer.addEvent(msg, ts);
+				buffer.addEvent(it.data, it.numBytes, ts);
 		}
 
 		midi.swapWith(buffer);
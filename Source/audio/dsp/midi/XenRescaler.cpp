@@ -36,16 +36,19 @@ namespace dsp
 		for (const auto it : midi)
 		{
 			const auto ts = it.samplePosition;
+			if (!isNoteOnOrOff(it.data))
+			{
+				buffer.addEvent(it.data, it.numBytes, ts);
+				continue;
+			}
 			const auto msg = it.getMessage();
 			if (msg.isNoteOn())
 			{
 				auto& processNoteOn = noteOnFuncs[static_cast<int>(type)];
 				processNoteOn(msg, buffer, xen, basePitch, masterTune, pitchbendRange, ts);
 			}
-			else if (msg.isNoteOff())
-				processNoteOff(buffer, ts);
 			else
-				buffer.addEvent(msg, ts);
+				processNoteOff(buffer, ts);
 		}
 	}
 
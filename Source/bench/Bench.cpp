@@ -0,0 +1,153 @@
+#include "Bench.h"
+#include "ConvolverFFT.h"
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+
+namespace bench
+{
+	namespace json
+	{
+		inline std::string escape(const std::string& str)
+		{
+			std::string escaped;
+			for (const auto c : str)
+			{
+				if (c == '"' || c == '\\')
+					escaped += '\\';
+				escaped += c;
+			}
+			return escaped;
+		}
+	}
+
+	std::string toJSON(const std::vector<Result>& results, int blockSizeCompiled)
+	{
+		std::ostringstream stream;
+		stream << "{\n";
+		stream << "\t\"version\": 1,\n";
+		stream << "\t\"blockSizeCompiled\": " << blockSizeCompiled << ",\n";
+		stream << "\t\"unit\": \"ns/sample\",\n";
+		stream << "\t\"results\": [\n";
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const auto& result = results[i];
+			char ns[32];
+			std::snprintf(ns, sizeof(ns), "%.4f", result.nsPerSample);
+			stream << "\t\t{ \"name\": \"" << json::escape(result.name) << "\""
+				<< ", \"precision\": \"" << result.precision << "\""
+				<< ", \"factor\": " << result.factor
+				<< ", \"blockSize\": " << result.blockSize
+				<< ", \"nsPerSample\": " << ns << " }"
+				<< (i + 1 < results.size() ? "," : "") << "\n";
+		}
+		stream << "\t]\n";
+		stream << "}\n";
+		return stream.str();
+	}
+
+	template<typename Float>
+	int measureConvolverCrossover(int numChannels, int numSamples)
+	{
+		using namespace dsp;
+		using Clock = std::chrono::steady_clock;
+
+		std::vector<std::vector<Float>> buffer(numChannels, std::vector<Float>(numSamples));
+		std::vector<Float*> samples;
+		for (auto& channel : buffer)
+		{
+			for (auto s = 0; s < numSamples; ++s)
+				channel[s] = static_cast<Float>(std::sin(static_cast<double>(s) * .1));
+			samples.push_back(channel.data());
+		}
+
+		// a long run of the same block size, like an oversampler would see
+		static constexpr int BlockSize = BlockSize2x;
+		const auto measure = [&](auto&& process)
+		{
+			const auto start = Clock::now();
+			for (auto s = 0; s + BlockSize <= numSamples; s += BlockSize)
+			{
+				Float* block[NumChannels];
+				for (auto ch = 0; ch < numChannels; ++ch)
+					block[ch] = samples[ch] + s;
+				process(block);
+			}
+			return std::chrono::duration<double>(Clock::now() - start).count();
+		};
+
+		auto ir = std::make_unique<ImpulseResponse<Float>>();
+		for (auto size = 8; size < ImpulseResponse<Float>::Size; size += 8)
+		{
+			ir->size = size;
+			for (auto i = 0; i < size; ++i)
+				(*ir)[i] = static_cast<Float>(1. / static_cast<double>(size));
+
+			auto kernel = std::make_unique<ConvolverKernel<Float>>();
+			kernel->prepare(*ir);
+			auto direct = std::make_unique<Convolver<Float>>();
+			direct->prepare(*kernel);
+			const auto durationDirect = measure([&](Float** block)
+			{
+				direct->processBlock(block, numChannels, BlockSize);
+			});
+
+			ConvolverFFTKernel<Float> spectra;
+			spectra.prepare(*ir);
+			auto partitioned = std::make_unique<ConvolverFFT<Float>>();
+			partitioned->prepare(spectra);
+			const auto durationFFT = measure([&](Float** block)
+			{
+				partitioned->processBlock(block, numChannels, BlockSize);
+			});
+
+			if (durationFFT < durationDirect)
+				return size;
+		}
+		return ImpulseResponse<Float>::Size;
+	}
+
+	template int measureConvolverCrossover<float>(int, int);
+	template int measureConvolverCrossover<double>(int, int);
+
+	template<typename Float>
+	double measureOversamplerThroughput(double sampleRate, dsp::OversamplingOrder order, dsp::OversamplerMode mode,
+		dsp::OversamplerQuality quality, int numChannels, int hostBlockSize, int numSamples)
+	{
+		using namespace dsp;
+		using Clock = std::chrono::steady_clock;
+
+		std::vector<std::vector<Float>> buffer(numChannels, std::vector<Float>(numSamples));
+		for (auto& channel : buffer)
+			for (auto s = 0; s < numSamples; ++s)
+				channel[s] = static_cast<Float>(std::sin(static_cast<double>(s) * .1));
+
+		auto oversampler = std::make_unique<Oversampler<Float>>();
+		oversampler->prepare(sampleRate, order, mode, quality);
+
+		const auto start = Clock::now();
+		for (auto h = 0; h + hostBlockSize <= numSamples; h += hostBlockSize)
+		{
+			for (auto s = 0; s < hostBlockSize; s += BlockSize)
+			{
+				Float* block[NumChannels];
+				for (auto ch = 0; ch < numChannels; ++ch)
+					block[ch] = buffer[ch].data() + h + s;
+				const auto dif = hostBlockSize - s;
+				const auto numSamplesBlock = dif < BlockSize ? dif : BlockSize;
+
+				oversampler->upsample(block, numChannels, numSamplesBlock);
+				oversampler->downsample(block, numSamplesBlock);
+			}
+		}
+		const auto duration = std::chrono::duration<double>(Clock::now() - start).count();
+		const auto numSamplesProcessed = numSamples - numSamples % hostBlockSize;
+		return duration * 1e9 / static_cast<double>(numSamplesProcessed);
+	}
+
+	template double measureOversamplerThroughput<float>(double, dsp::OversamplingOrder, dsp::OversamplerMode,
+		dsp::OversamplerQuality, int, int, int);
+	template double measureOversamplerThroughput<double>(double, dsp::OversamplingOrder, dsp::OversamplerMode,
+		dsp::OversamplerQuality, int, int, int);
+}
\ No newline at end of file
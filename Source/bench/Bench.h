@@ -0,0 +1,71 @@
+#pragma once
+#include "../audio/dsp/Oversampler.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+	struct Result
+	{
+		std::string name, precision;
+		int factor, blockSize;
+		double nsPerSample;
+	};
+
+	/* how long each measurement runs and how often it's repeated. the fastest repetition counts,
+	because anything slower than that was the machine doing something else */
+	struct Settings
+	{
+		double secondsPerRun;
+		int numRuns;
+	};
+
+	/* settings, numSamplesPerCall, process(), returns nanoseconds per sample
+	calls process until secondsPerRun are over, numRuns times */
+	template<typename Process>
+	double measure(const Settings& settings, int numSamplesPerCall, Process&& process)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		// warm up caches and branch predictors
+		for (auto i = 0; i < 64; ++i)
+			process();
+
+		auto best = 1e300;
+		for (auto r = 0; r < settings.numRuns; ++r)
+		{
+			long long numCalls = 0;
+			const auto start = Clock::now();
+			auto elapsed = 0.;
+			do
+			{
+				for (auto i = 0; i < 64; ++i)
+					process();
+				numCalls += 64;
+				elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+			} while (elapsed < settings.secondsPerRun);
+			const auto ns = elapsed * 1e9 / (static_cast<double>(numCalls) * numSamplesPerCall);
+			if (ns < best)
+				best = ns;
+		}
+		return best;
+	}
+
+	/* results, blockSizeCompiled, returns them as a json document */
+	std::string toJSON(const std::vector<Result>&, int);
+
+	/* numChannels, numSamples
+	returns the smallest number of taps, for which ConvolverFFT
+	outperforms the oversampler's Convolver on this machine */
+	template<typename Float>
+	int measureConvolverCrossover(int, int);
+
+	/* sampleRate, order, mode, quality, numChannels, hostBlockSize, numSamples
+	returns the time an up- and downsampling round trip of numSamples takes, in nanoseconds
+	per sample, when the host's blocks are cut into chunks of BlockSize like Processor does.
+	build with different PPDBlockSize to compare them */
+	template<typename Float>
+	double measureOversamplerThroughput(double, dsp::OversamplingOrder, dsp::OversamplerMode,
+		dsp::OversamplerQuality, int, int, int);
+}
\ No newline at end of file
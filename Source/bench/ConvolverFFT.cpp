@@ -0,0 +1,173 @@
+#include "ConvolverFFT.h"
+
+namespace bench
+{
+	template<typename Float>
+	ConvolverFFTKernel<Float>::ConvolverFFTKernel() :
+		spectra(),
+		numPartitions(0)
+	{
+	}
+
+	template<typename Float>
+	void ConvolverFFTKernel<Float>::prepare(const dsp::ImpulseResponse<Float>& ir)
+	{
+		dsp::FFTComplex<Float> fft;
+		fft.prepare(PartitionOrder + 1);
+
+		numPartitions = std::max(1, (ir.size + PartitionSize - 1) / PartitionSize);
+		spectra.assign(numPartitions * FFTSize, Complex());
+
+		// the fft isn't normalized, so the inverse's gain goes into the ir
+		const auto gain = static_cast<Float>(1. / static_cast<double>(FFTSize));
+		for (auto p = 0; p < numPartitions; ++p)
+		{
+			auto spectrum = &spectra[p * FFTSize];
+			const auto start = p * PartitionSize;
+			const auto end = std::min(start + PartitionSize, ir.size);
+			for (auto i = start; i < end; ++i)
+				spectrum[i - start] = Complex(ir[i] * gain, static_cast<Float>(0));
+			fft.forward(spectrum);
+		}
+	}
+
+	template struct ConvolverFFTKernel<float>;
+	template struct ConvolverFFTKernel<double>;
+
+	template<typename Float>
+	ConvolverFFT<Float>::ConvolverFFT() :
+		kernel(nullptr),
+		fft(),
+		spectra(),
+		inputs(),
+		outputs(),
+		accumulator(),
+		numPartitions(0),
+		partitionIdx(0),
+		fifoIdx(0)
+	{
+		fft.prepare(PartitionOrder + 1);
+	}
+
+	template<typename Float>
+	void ConvolverFFT<Float>::prepare(const Kernel& _kernel)
+	{
+		kernel = &_kernel;
+		numPartitions = kernel->numPartitions;
+		spectra.assign(NumPairs * numPartitions * FFTSize, Complex());
+
+		for (auto& input : inputs)
+			input.fill(Complex());
+		for (auto& output : outputs)
+			output.fill(Complex());
+		partitionIdx = 0;
+		fifoIdx = 0;
+	}
+
+	template<typename Float>
+	void ConvolverFFT<Float>::processBlock(Float* const* samplesOut, const Float* const* samplesIn,
+		int numChannels, int numSamples) noexcept
+	{
+		const auto numPairs = (numChannels + 1) / 2;
+		auto s = 0;
+		while (s < numSamples)
+		{
+			const auto numFifo = std::min(numSamples - s, PartitionSize - fifoIdx);
+			for (auto pair = 0; pair < numPairs; ++pair)
+			{
+				const auto chL = pair * 2;
+				const auto hasR = chL + 1 < numChannels;
+				auto input = &inputs[pair][PartitionSize + fifoIdx];
+				const auto output = &outputs[pair][fifoIdx];
+				const auto inL = samplesIn[chL] + s;
+				auto outL = samplesOut[chL] + s;
+
+				if (hasR)
+				{
+					const auto inR = samplesIn[chL + 1] + s;
+					auto outR = samplesOut[chL + 1] + s;
+					for (auto i = 0; i < numFifo; ++i)
+					{
+						input[i] = Complex(inL[i], inR[i]);
+						outL[i] = output[i].real();
+						outR[i] = output[i].imag();
+					}
+				}
+				else
+					for (auto i = 0; i < numFifo; ++i)
+					{
+						input[i] = Complex(inL[i], static_cast<Float>(0));
+						outL[i] = output[i].real();
+					}
+			}
+
+			s += numFifo;
+			fifoIdx += numFifo;
+			if (fifoIdx == PartitionSize)
+			{
+				fifoIdx = 0;
+				processPartition(numPairs);
+			}
+		}
+	}
+
+	template<typename Float>
+	void ConvolverFFT<Float>::processBlock(Float* const* samples, int numChannels, int numSamples) noexcept
+	{
+		processBlock(samples, samples, numChannels, numSamples);
+	}
+
+	template<typename Float>
+	void ConvolverFFT<Float>::processPartition(int numPairs) noexcept
+	{
+		const auto partitionStride = numPartitions * FFTSize;
+		for (auto pair = 0; pair < numPairs; ++pair)
+		{
+			auto& input = inputs[pair];
+			auto pairSpectra = &spectra[pair * partitionStride];
+
+			// the newest spectrum goes into the frequency domain delay line
+			auto spectrum = &pairSpectra[partitionIdx * FFTSize];
+			for (auto i = 0; i < FFTSize; ++i)
+				spectrum[i] = input[i];
+			fft.forward(spectrum);
+			for (auto i = 0; i < PartitionSize; ++i)
+				input[i] = input[PartitionSize + i];
+
+			// y = sum of the p-th latest spectrum times the p-th ir partition
+			accumulator.fill(Complex());
+			auto idx = partitionIdx;
+			for (auto p = 0; p < numPartitions; ++p)
+			{
+				const auto x = &pairSpectra[idx * FFTSize];
+				const auto h = &kernel->spectra[p * FFTSize];
+				for (auto k = 0; k < FFTSize; ++k)
+				{
+					const auto re = accumulator[k].real() + x[k].real() * h[k].real() - x[k].imag() * h[k].imag();
+					const auto im = accumulator[k].imag() + x[k].real() * h[k].imag() + x[k].imag() * h[k].real();
+					accumulator[k] = Complex(re, im);
+				}
+				if (--idx == -1)
+					idx = numPartitions - 1;
+			}
+
+			// overlap-save: the first half is circular aliasing
+			fft.inverse(accumulator.data());
+			auto& output = outputs[pair];
+			for (auto i = 0; i < PartitionSize; ++i)
+				output[i] = accumulator[PartitionSize + i];
+		}
+
+		if (++partitionIdx == numPartitions)
+			partitionIdx = 0;
+	}
+
+	template<typename Float>
+	int ConvolverFFT<Float>::getLatency() const noexcept
+	{
+		return PartitionSize;
+	}
+
+	template struct ConvolverFFT<float>;
+	template struct ConvolverFFT<double>;
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+#include "../audio/dsp/Oversampler.h"
+#include <complex>
+#include <vector>
+
+namespace bench
+{
+	/* an impulse response cut into partitions of PartitionSize,
+	each zero-padded to FFTSize and transformed */
+	template<typename Float>
+	struct ConvolverFFTKernel
+	{
+		static constexpr int PartitionOrder = 6;
+		static constexpr int PartitionSize = 1 << PartitionOrder;
+		static constexpr int FFTSize = PartitionSize * 2;
+		using Complex = std::complex<Float>;
+
+		ConvolverFFTKernel();
+
+		/* ir, allocates */
+		void prepare(const dsp::ImpulseResponse<Float>&);
+
+		std::vector<Complex> spectra;
+		int numPartitions;
+	};
+
+	/* uniformly partitioned overlap-save convolution, what the oversampler's Convolver
+	is measured against. its filters stay below the crossover, so only the bench has it.
+	channels are convolved in pairs, one in the real and one in the imaginary part.
+	adds PartitionSize samples of latency on top of the impulse response's */
+	template<typename Float>
+	struct ConvolverFFT
+	{
+		using Kernel = ConvolverFFTKernel<Float>;
+		static constexpr int PartitionOrder = Kernel::PartitionOrder;
+		static constexpr int PartitionSize = Kernel::PartitionSize;
+		static constexpr int FFTSize = Kernel::FFTSize;
+		static constexpr int NumPairs = (dsp::NumChannels + 1) / 2;
+		using Complex = std::complex<Float>;
+		using Block = std::array<Complex, FFTSize>;
+
+		ConvolverFFT();
+
+		/* kernel, has to outlive the convolver's use of it. allocates */
+		void prepare(const Kernel&);
+
+		/* samplesOut, samplesIn, numChannels, numSamples
+		samplesOut can be samplesIn */
+		void processBlock(Float* const*, const Float* const*, int, int) noexcept;
+
+		/* samples, numChannels, numSamples */
+		void processBlock(Float* const*, int, int) noexcept;
+
+		int getLatency() const noexcept;
+
+	private:
+		const Kernel* kernel;
+		dsp::FFTComplex<Float> fft;
+		std::vector<Complex> spectra;
+		std::array<Block, NumPairs> inputs, outputs;
+		Block accumulator;
+		int numPartitions, partitionIdx, fifoIdx;
+
+		/* numPairs */
+		void processPartition(int) noexcept;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,555 @@
+#include "Bench.h"
+#include "ConvolverFFT.h"
+#include "Verify.h"
+#include "../audio/dsp/SlewLimiter.h"
+#include "../audio/dsp/Crossover.h"
+#include "../audio/dsp/Oversampler.h"
+#include "../audio/dsp/Smooth.h"
+#include "../audio/dsp/Gain.h"
+#include "../audio/dsp/MixProcessor.h"
+#include "../audio/dsp/MidSide.h"
+#include "../audio/dsp/Distortion.h"
+#include "../arch/FormulaParser.h"
+#include "../arch/Math.h"
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+namespace bench
+{
+	using namespace dsp;
+
+	/* a suite measures its primitive at every oversampling factor and host block size.
+	at a factor of 2 the primitive runs at twice the sample rate over twice the samples,
+	like it would inside the oversampler, but the result stays in ns per sample of the host rate.
+	objects with internal buffers get the samples in chunks of BlockSize */
+	struct Suite
+	{
+		static constexpr int NumChannels = 2;
+		static constexpr double SampleRate = 48000.;
+
+		Suite(const Settings& _settings, const std::string& _filter) :
+			settings(_settings),
+			filter(_filter),
+			results()
+		{
+		}
+
+		bool accepts(const std::string& name) const
+		{
+			return filter.empty() || name.find(filter) != std::string::npos;
+		}
+
+		/* name, makeProcess(sampleRate), which returns process(samples, numChannels, numSamples) */
+		template<typename Float, typename MakeProcess>
+		void run(const std::string& name, MakeProcess&& makeProcess)
+		{
+			if (!accepts(name))
+				return;
+			const auto precision = sizeof(Float) == sizeof(float) ? "float" : "double";
+
+			for (auto factor : { 1, 2, 4 })
+				for (auto blockSize : { 32, 128, 512 })
+				{
+					const auto numSamples = blockSize * factor;
+					std::vector<std::vector<Float>> buffer(NumChannels, std::vector<Float>(numSamples));
+					for (auto& channel : buffer)
+						for (auto s = 0; s < numSamples; ++s)
+							channel[s] = static_cast<Float>(.8 * std::sin(static_cast<double>(s) * .05));
+					Float* samples[NumChannels];
+					for (auto ch = 0; ch < NumChannels; ++ch)
+						samples[ch] = buffer[ch].data();
+
+					auto process = makeProcess(SampleRate * factor);
+					// per sample of the host rate
+					const auto ns = measure(settings, blockSize, [&]()
+					{
+						process(samples, NumChannels, numSamples);
+					});
+
+					results.push_back({ name, precision, factor, blockSize, ns });
+					std::cout << name << " " << precision << " " << factor << "x, block " << blockSize
+						<< ": " << ns << " ns/sample\n";
+				}
+		}
+
+		/* name, makeProcess(sampleRate), like run, but hands the samples to process in chunks of BlockSize */
+		template<typename Float, typename MakeProcess>
+		void runChunked(const std::string& name, MakeProcess&& makeProcess)
+		{
+			run<Float>(name, [&](double sampleRate)
+			{
+				return [process = makeProcess(sampleRate)](Float* const* samples, int numChannels, int numSamples) mutable
+				{
+					for (auto s = 0; s < numSamples; s += BlockSize)
+					{
+						Float* block[NumChannels];
+						for (auto ch = 0; ch < numChannels; ++ch)
+							block[ch] = samples[ch] + s;
+						const auto dif = numSamples - s;
+						process(block, numChannels, dif < BlockSize ? dif : BlockSize);
+					}
+				};
+			});
+		}
+
+		/* name, clip(x) */
+		template<typename Float, typename Clip>
+		void runClipper(const std::string& name, Clip&& clip)
+		{
+			run<Float>(name, [&](double)
+			{
+				return [clip](Float* const* samples, int numChannels, int numSamples)
+				{
+					for (auto ch = 0; ch < numChannels; ++ch)
+					{
+						auto smpls = samples[ch];
+						for (auto s = 0; s < numSamples; ++s)
+							smpls[s] = clip(smpls[s]);
+					}
+				};
+			});
+		}
+
+		Settings settings;
+		std::string filter;
+		std::vector<Result> results;
+	};
+
+	template<typename Float>
+	void runSuite(Suite& suite)
+	{
+		suite.runChunked<Float>("SlewLimiter", [](double sampleRate)
+		{
+			auto slew = std::make_shared<SlewLimiterStereo<Float>>();
+			const auto rate = SlewLimiterStereo<Float>::freqHzToSlewRate(static_cast<Float>(440), static_cast<Float>(sampleRate));
+			return [slew, rate](Float* const* samples, int numChannels, int numSamples)
+			{
+				(*slew)(samples, rate, rate, numChannels, numSamples, SlewLimiter<Float>::LP, 1);
+			};
+		});
+
+		for (auto order : { 2, 4, 8 })
+			suite.runChunked<Float>("SlewLimiterOrder" + std::to_string(order), [order](double sampleRate)
+			{
+				auto slew = std::make_shared<SlewLimiterStereo<Float>>();
+				const auto rate = SlewLimiterStereo<Float>::freqHzToSlewRate(static_cast<Float>(440), static_cast<Float>(sampleRate));
+				return [slew, rate, order](Float* const* samples, int numChannels, int numSamples)
+				{
+					(*slew)(samples, rate, rate, numChannels, numSamples, SlewLimiter<Float>::LP, order);
+				};
+			});
+
+		suite.runChunked<Float>("SlewLimiterBP", [](double sampleRate)
+		{
+			auto slew = std::make_shared<SlewLimiterStereo<Float>>();
+			slew->prepare(static_cast<Float>(sampleRate));
+			const auto rate = SlewLimiterStereo<Float>::freqHzToSlewRate(static_cast<Float>(440), static_cast<Float>(sampleRate));
+			return [slew, rate](Float* const* samples, int numChannels, int numSamples)
+			{
+				(*slew)(samples, rate, rate, numChannels, numSamples, SlewLimiter<Float>::BP, 1);
+			};
+		});
+
+		suite.runChunked<Float>("SlewLimiterCrossfade", [](double sampleRate)
+		{
+			// the type changes with every call, so it never stops crossfading
+			struct State
+			{
+				SlewLimiterStereo<Float> slew;
+				int idx = 0;
+			};
+			auto state = std::make_shared<State>();
+			state->slew.prepare(static_cast<Float>(sampleRate));
+			const auto rate = SlewLimiterStereo<Float>::freqHzToSlewRate(static_cast<Float>(440), static_cast<Float>(sampleRate));
+			return [state, rate](Float* const* samples, int numChannels, int numSamples)
+			{
+				const auto type = static_cast<typename SlewLimiter<Float>::Type>(state->idx++ % SlewLimiter<Float>::NumTypes);
+				state->slew(samples, rate, rate, numChannels, numSamples, type, 1);
+			};
+		});
+
+		suite.runChunked<Float>("SlewLimiterModulated", [](double sampleRate)
+		{
+			// a slew rate per sample, like while the parameter is smoothing
+			struct State
+			{
+				SlewLimiterStereo<Float> slew;
+				std::array<Float, BlockSize> rates;
+			};
+			auto state = std::make_shared<State>();
+			for (auto s = 0; s < BlockSize; ++s)
+				state->rates[s] = SlewLimiterStereo<Float>::freqHzToSlewRate(static_cast<Float>(440 + s), static_cast<Float>(sampleRate));
+			return [state](Float* const* samples, int numChannels, int numSamples)
+			{
+				state->slew(samples, state->rates.data(), state->rates.data(), numChannels, numSamples, SlewLimiter<Float>::LP, 1);
+			};
+		});
+
+		for (auto numBands = 2; numBands <= 5; ++numBands)
+		{
+			// split and join of the Bands param, without anything in between
+			suite.runChunked<Float>("Crossover" + std::to_string(numBands) + "Band", [numBands](double sampleRate)
+			{
+				auto crossover = std::make_shared<Crossover<Float, 5>>();
+				crossover->prepare(static_cast<Float>(sampleRate), numBands);
+				crossover->setFrequencies({ 120, 800, 3000, 9000 });
+				return [crossover, numBands](Float* const* samples, int numChannels, int numSamples)
+				{
+					crossover->split(samples, numChannels, numSamples, numBands);
+					crossover->join(samples, numChannels, numSamples);
+				};
+			});
+		}
+
+		suite.runChunked<Float>("MultibandSlew5Band", [](double sampleRate)
+		{
+			// each band slews an octave faster than the one below it
+			struct State
+			{
+				Crossover<Float, 5> crossover;
+				std::array<SlewLimiterStereo<Float>, 5> slews;
+				std::array<Float, 5> rates;
+			};
+			auto state = std::make_shared<State>();
+			state->crossover.prepare(static_cast<Float>(sampleRate), 5);
+			state->crossover.setFrequencies({ 120, 800, 3000, 9000 });
+			for (auto b = 0; b < 5; ++b)
+			{
+				state->slews[b].prepare(static_cast<Float>(sampleRate));
+				state->rates[b] = SlewLimiterStereo<Float>::freqHzToSlewRate(static_cast<Float>(110 << b), static_cast<Float>(sampleRate));
+			}
+			return [state](Float* const* samples, int numChannels, int numSamples)
+			{
+				state->crossover.split(samples, numChannels, numSamples, 5);
+				for (auto b = 0; b < 5; ++b)
+				{
+					typename Crossover<Float, 5>::Band band = { samples[0], samples[numChannels - 1] };
+					if (b != 0)
+						band = state->crossover.getBand(b);
+					const auto rate = state->rates[b];
+					state->slews[b](band.data(), rate, rate, numChannels, numSamples, SlewLimiter<Float>::LP, 1);
+				}
+				state->crossover.join(samples, numChannels, numSamples);
+			};
+		});
+
+		suite.runChunked<Float>("noteInFreqHz2", [](double)
+		{
+			return [](Float* const* samples, int numChannels, int numSamples)
+			{
+				for (auto ch = 0; ch < numChannels; ++ch)
+					math::noteInFreqHz2(samples[ch], numSamples);
+			};
+		});
+
+		for (auto size : { 16, 64, 256 })
+		{
+			// symmetric like the linear phase filters of the oversampler
+			auto ir = std::make_shared<ImpulseResponse<Float>>();
+			ir->size = size;
+			for (auto i = 0; i < size; ++i)
+				(*ir)[i] = static_cast<Float>(1. / static_cast<double>(size));
+			auto kernel = std::make_shared<ConvolverKernel<Float>>();
+			kernel->prepare(*ir);
+
+			suite.runChunked<Float>("Convolver" + std::to_string(size), [kernel](double)
+			{
+				auto convolver = std::make_shared<Convolver<Float>>();
+				convolver->prepare(*kernel);
+				return [kernel, convolver](Float* const* samples, int numChannels, int numSamples)
+				{
+					convolver->processBlock(samples, numChannels, numSamples);
+				};
+			});
+
+			// the same filter partitioned, where the two cross is measureConvolverCrossover's result
+			auto spectra = std::make_shared<ConvolverFFTKernel<Float>>();
+			spectra->prepare(*ir);
+
+			suite.runChunked<Float>("ConvolverFFT" + std::to_string(size), [spectra](double)
+			{
+				auto convolver = std::make_shared<ConvolverFFT<Float>>();
+				convolver->prepare(*spectra);
+				return [spectra, convolver](Float* const* samples, int numChannels, int numSamples)
+				{
+					convolver->processBlock(samples, numChannels, numSamples);
+				};
+			});
+		}
+
+		if (suite.accepts("ConvolverCrossover"))
+		{
+			const auto precision = sizeof(Float) == sizeof(float) ? "float" : "double";
+			std::cout << "ConvolverCrossover " << precision << ": ConvolverFFT is faster from "
+				<< measureConvolverCrossover<Float>(Suite::NumChannels, 1 << 16) << " taps\n";
+		}
+
+		for (auto mode = 0; mode < static_cast<int>(OversamplerMode::NumModes); ++mode)
+		{
+			static constexpr const char* ModeNames[] = { "Direct", "Polyphase", "MinimumPhase", "IIR", "Halfband" };
+			const auto oversamplerMode = static_cast<OversamplerMode>(mode);
+
+			// the factor is the oversampler's own here, it always gets the host rate
+			const auto name = std::string("Oversampler") + ModeNames[mode];
+			suite.run<Float>(name, [oversamplerMode](double sampleRate)
+			{
+				const auto factor = static_cast<int>(sampleRate / Suite::SampleRate);
+				const auto order = factor == 1 ? OversamplingOrder::x1 : factor == 2 ? OversamplingOrder::x2 : OversamplingOrder::x4;
+				auto oversampler = std::make_shared<Oversampler<Float>>();
+				oversampler->prepare(Suite::SampleRate, order, oversamplerMode, OversamplerQuality::Balanced);
+				return [oversampler, factor](Float* const* samples, int numChannels, int numSamples)
+				{
+					// only the host's samples of the block
+					numSamples /= factor;
+					for (auto s = 0; s < numSamples; s += BlockSize)
+					{
+						Float* block[Suite::NumChannels];
+						for (auto ch = 0; ch < numChannels; ++ch)
+							block[ch] = samples[ch] + s;
+						const auto dif = numSamples - s;
+						const auto numSamplesBlock = dif < BlockSize ? dif : BlockSize;
+						oversampler->upsample(block, numChannels, numSamplesBlock);
+						oversampler->downsample(block, numSamplesBlock);
+					}
+				};
+			});
+		}
+
+		if (suite.accepts("OversamplerThroughput"))
+		{
+			// a round trip on host buffers of 1024 samples, in chunks of the compiled BlockSize
+			const auto precision = sizeof(Float) == sizeof(float) ? "float" : "double";
+			static constexpr const char* ModeNames[] = { "Polyphase", "Halfband", "IIR" };
+			static constexpr OversamplerMode Modes[] = { OversamplerMode::Polyphase, OversamplerMode::Halfband, OversamplerMode::IIR };
+			for (auto m = 0; m < 3; ++m)
+				for (const auto order : { OversamplingOrder::x2, OversamplingOrder::x4, OversamplingOrder::x16 })
+				{
+					const auto ns = measureOversamplerThroughput<Float>(Suite::SampleRate, order, Modes[m],
+						OversamplerQuality::Balanced, Suite::NumChannels, 1024, 1 << 16);
+					std::cout << "OversamplerThroughput" << ModeNames[m] << " " << precision << " "
+						<< getOversamplingFactor(order) << "x, BlockSize " << BlockSize << ": " << ns << " ns/sample\n";
+				}
+		}
+
+		for (const auto numBands : { 1, 5 })
+		{
+			// what one lane of the plugin runs, at the oversampler's own factor like above
+			const auto name = "Lane" + std::to_string(numBands) + "Band";
+			suite.run<Float>(name, [numBands](double sampleRate)
+			{
+				const auto factor = static_cast<int>(sampleRate / Suite::SampleRate);
+				const auto order = factor == 1 ? OversamplingOrder::x1 : factor == 2 ? OversamplingOrder::x2 : OversamplingOrder::x4;
+				auto lane = std::make_shared<Lane<Float>>();
+				lane->prepare(Suite::SampleRate, { order, OversamplerMode::Polyphase, 1, numBands });
+				return [lane, factor](Float* const* samples, int numChannels, int numSamples)
+				{
+					numSamples /= factor;
+					for (auto s = 0; s < numSamples; s += BlockSize)
+					{
+						Float* block[Suite::NumChannels];
+						for (auto ch = 0; ch < numChannels; ++ch)
+							block[ch] = samples[ch] + s;
+						const auto dif = numSamples - s;
+						(*lane)(block, numChannels, dif < BlockSize ? dif : BlockSize);
+					}
+				};
+			});
+		}
+
+		suite.runChunked<Float>("Smooth", [](double sampleRate)
+		{
+			struct State
+			{
+				smooth::Smooth<Float> smooth;
+				std::array<Float, BlockSize> buffer;
+				bool up;
+			};
+			auto state = std::make_shared<State>();
+			state->smooth.makeFromDecayInMs(static_cast<Float>(20), static_cast<Float>(sampleRate));
+			state->up = false;
+			return [state](Float* const*, int, int numSamples)
+			{
+				// a new destination each block keeps it smoothing
+				state->up = !state->up;
+				state->smooth(state->buffer.data(), static_cast<Float>(state->up ? 1 : 0), numSamples);
+			};
+		});
+
+		suite.runChunked<Float>("Lowpass", [](double sampleRate)
+		{
+			auto lowpass = std::make_shared<smooth::Lowpass<Float, false>>();
+			lowpass->makeFromDecayInHz(static_cast<Float>(1000), static_cast<Float>(sampleRate));
+			return [lowpass](Float* const* samples, int numChannels, int numSamples)
+			{
+				for (auto ch = 0; ch < numChannels; ++ch)
+					(*lowpass)(samples[ch], numSamples);
+			};
+		});
+
+		suite.runChunked<Float>("Gain", [](double sampleRate)
+		{
+			auto gain = std::make_shared<Gain<Float, 13.>>(static_cast<Float>(0));
+			gain->prepare(sampleRate);
+			auto db = std::make_shared<Float>(static_cast<Float>(0));
+			return [gain, db](Float* const* samples, int numChannels, int numSamples)
+			{
+				// a new value each block keeps it smoothing
+				*db = *db == static_cast<Float>(0) ? static_cast<Float>(-6) : static_cast<Float>(0);
+				(*gain)(samples, *db, numChannels, numSamples);
+			};
+		});
+
+		for (auto delta : { false, true })
+			suite.runChunked<Float>(delta ? "ParallelJoinDelta" : "ParallelJoinMix", [delta](double)
+			{
+				auto parallel = std::make_shared<ParallelProcessor<Float, 2, Suite::NumChannels>>();
+				return [parallel, delta](Float* const* samples, int numChannels, int numSamples)
+				{
+					const auto mix = static_cast<Float>(.5);
+					parallel->split(samples, numChannels, numSamples);
+					if (delta)
+						parallel->joinDelta(samples, mix, numChannels, numSamples);
+					else
+						parallel->joinMix(samples, mix, numChannels, numSamples);
+				};
+			});
+
+		suite.runChunked<Float>("LatencyCompensation", [](double)
+		{
+			auto compensation = std::make_shared<LatencyCompensation<Float>>();
+			compensation->prepare(37);
+			return [compensation](Float* const* samples, int numChannels, int numSamples)
+			{
+				(*compensation)(samples, numChannels, numSamples);
+			};
+		});
+
+		const auto ceil = static_cast<Float>(1);
+		const auto k = static_cast<Float>(4);
+		suite.runClipper<Float>("hardclip", [ceil](Float x) { return hardclip(x, ceil); });
+		suite.runClipper<Float>("softclipCubic", [ceil](Float x) { return softclipCubic(x, ceil); });
+		suite.runClipper<Float>("softclipAtan", [ceil, k](Float x) { return softclipAtan(x, ceil, k); });
+		suite.runClipper<Float>("softclipSigmoid", [ceil, k](Float x) { return softclipSigmoid(x, ceil, k); });
+		suite.runClipper<Float>("softclipAtan2", [ceil, k](Float x) { return softclipAtan2(x, ceil, k); });
+		suite.runClipper<Float>("softclipFuzzExponential", [ceil, k](Float x) { return softclipFuzzExponential(x, ceil, k); });
+		suite.runClipper<Float>("softclipFiresledge", [ceil, k](Float x) { return softclipFiresledge(x, ceil, k); });
+		suite.runClipper<Float>("softclipPrismaHeavy", [ceil](Float x) { return softclipPrismaHeavy(x, ceil, static_cast<Float>(.5)); });
+	}
+
+	inline void runSuiteDoubleOnly(Suite& suite)
+	{
+		for (auto decode : { false, true })
+			suite.runChunked<double>(decode ? "midSideDecode" : "midSideEncode", [decode](double)
+			{
+				return [decode](double* const* samples, int, int numSamples)
+				{
+					if (decode)
+						midSideDecode(samples, numSamples);
+					else
+						midSideEncode(samples, numSamples);
+				};
+			});
+	}
+
+	inline void runSuiteParser(Suite& suite)
+	{
+		auto parser = std::make_shared<fx::Parser>();
+		(*parser)(fx::String("sin(x * 3.14) * .5 + x * x"));
+		// the parser only knows float
+		suite.run<float>("Parser", [parser](double)
+		{
+			return [parser](float* const* samples, int numChannels, int numSamples)
+			{
+				const fx::Parser& evaluate = *parser;
+				for (auto ch = 0; ch < numChannels; ++ch)
+				{
+					auto smpls = samples[ch];
+					for (auto s = 0; s < numSamples; ++s)
+						smpls[s] = evaluate(smpls[s]);
+				}
+			};
+		});
+	}
+
+	inline void printUsage()
+	{
+		std::cout <<
+			"measures the dsp primitives of Slew Over in ns per sample\n"
+			"\n"
+			"usage: SlewOverBench [options]\n"
+			"\n"
+			"  -o, --output <file.json>  writes the results as json\n"
+			"  -f, --filter <text>       only runs primitives whose name contains text\n"
+			"  -t, --time <seconds>      duration of each run, default: .05\n"
+			"  -r, --runs <n>            runs per measurement, the fastest counts. default: 5\n"
+			"  -v, --verify              runs the accuracy checks instead, exits with 1 if one fails.\n"
+			"                            -f filters them too\n";
+	}
+
+	inline int run(int argc, char* argv[])
+	{
+		Settings settings{ .05, 5 };
+		std::string output, filter;
+		auto verifyOnly = false;
+
+		for (auto i = 1; i < argc; ++i)
+		{
+			const std::string arg(argv[i]);
+			const auto hasValue = i + 1 < argc;
+			if (arg == "-h" || arg == "--help")
+			{
+				printUsage();
+				return 0;
+			}
+			else if (arg == "-v" || arg == "--verify")
+				verifyOnly = true;
+			else if ((arg == "-o" || arg == "--output") && hasValue)
+				output = argv[++i];
+			else if ((arg == "-f" || arg == "--filter") && hasValue)
+				filter = argv[++i];
+			else if ((arg == "-t" || arg == "--time") && hasValue)
+				settings.secondsPerRun = std::atof(argv[++i]);
+			else if ((arg == "-r" || arg == "--runs") && hasValue)
+				settings.numRuns = std::atoi(argv[++i]);
+			else
+			{
+				std::cerr << "unknown option: " << arg << "\n";
+				printUsage();
+				return 1;
+			}
+		}
+		if (settings.secondsPerRun <= 0. || settings.numRuns < 1)
+		{
+			std::cerr << "time and runs must be positive\n";
+			return 1;
+		}
+
+		if (verifyOnly)
+			return verify(filter) ? 0 : 1;
+
+		Suite suite(settings, filter);
+		runSuite<float>(suite);
+		runSuite<double>(suite);
+		runSuiteDoubleOnly(suite);
+		runSuiteParser(suite);
+
+		const auto json = toJSON(suite.results, BlockSize);
+		if (output.empty())
+			return 0;
+		std::ofstream file(output);
+		file << json;
+		if (!file)
+		{
+			std::cerr << "couldn't write " << output << "\n";
+			return 1;
+		}
+		return 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	return bench::run(argc, argv);
+}
\ No newline at end of file
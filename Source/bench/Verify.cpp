@@ -0,0 +1,266 @@
+#include "Verify.h"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace bench
+{
+	using namespace dsp;
+
+	template<typename Float>
+	Lane<Float>::Lane() :
+		oversampler(),
+		crossover(),
+		slews(),
+		rates(),
+		setup{ OversamplingOrder::x1, OversamplerMode::Polyphase, 1, 1 }
+	{
+	}
+
+	template<typename Float>
+	void Lane<Float>::prepare(double sampleRate, const LaneSetup& _setup)
+	{
+		setup = _setup;
+		oversampler.prepare(sampleRate, setup.order, setup.mode, OversamplerQuality::Balanced);
+		const auto sampleRateUp = static_cast<Float>(oversampler.sampleRateUp);
+		crossover.prepare(sampleRateUp, setup.numBands);
+		crossover.setFrequencies({ 120, 800, 3000, 9000 });
+		// each band slews an octave faster than the one below it
+		for (auto b = 0; b < MaxBands; ++b)
+		{
+			slews[b].prepare(sampleRateUp);
+			rates[b] = Slew::freqHzToSlewRate(static_cast<Float>(220 << b), sampleRateUp);
+		}
+	}
+
+	template<typename Float>
+	void Lane<Float>::operator()(Float* const* samples, int numChannels, int numSamples) noexcept
+	{
+		if (setup.numBands == 1 && crossover.getNumBands() == 1 && oversampler.canFuse())
+		{
+			const auto rate = rates[0];
+			slews[0](oversampler, samples, rate, rate, numChannels, numSamples, Slew::Type::LP, setup.filterOrder);
+			return;
+		}
+		const auto bufferInfo = oversampler.upsample(samples, numChannels, numSamples);
+		Float* samplesUp[] = { bufferInfo.smplsL, bufferInfo.smplsR };
+		process(samplesUp, bufferInfo.numChannels, bufferInfo.numSamples);
+		oversampler.downsample(samples, numSamples);
+	}
+
+	template<typename Float>
+	void Lane<Float>::process(Float* const* samples, int numChannels, int numSamples) noexcept
+	{
+		for (auto s = 0; s < numSamples; s += BlockSize)
+		{
+			const auto numSamplesBlock = std::min(numSamples - s, BlockSize);
+			Float* block[] = { samples[0] + s, samples[numChannels - 1] + s };
+			crossover.split(block, numChannels, numSamplesBlock, setup.numBands);
+			for (auto b = 0; b < crossover.getNumBands(); ++b)
+			{
+				typename Crossover<Float, MaxBands>::Band band = { block[0], block[1] };
+				if (b != 0)
+					band = crossover.getBand(b);
+				const auto rate = rates[b];
+				slews[b](band.data(), rate, rate, numChannels, numSamplesBlock, Slew::Type::LP, setup.filterOrder);
+			}
+			crossover.join(block, numChannels, numSamplesBlock);
+		}
+	}
+
+	template struct Lane<float>;
+	template struct Lane<double>;
+
+	namespace verification
+	{
+		static constexpr int NumChannels = 2;
+		static constexpr double SampleRate = 48000.;
+		using Signal = std::array<std::vector<double>, NumChannels>;
+
+		/* numSamples, a few partials and some noise at about -6 dbfs, different on each channel */
+		inline Signal makeSignal(int numSamples)
+		{
+			Signal signal;
+			auto noise = 1u;
+			for (auto ch = 0; ch < NumChannels; ++ch)
+			{
+				auto& channel = signal[ch];
+				channel.resize(numSamples);
+				for (auto s = 0; s < numSamples; ++s)
+				{
+					const auto t = static_cast<double>(s) / SampleRate;
+					noise = noise * 1664525u + 1013904223u;
+					const auto white = static_cast<double>(noise >> 8) / static_cast<double>(1 << 24) - .5;
+					channel[s] = .25 * std::sin(2. * Pi * (110. + ch * 7.) * t)
+						+ .125 * std::sin(2. * Pi * 1370. * t)
+						+ .0625 * std::sin(2. * Pi * (9100. - ch * 300.) * t)
+						+ .05 * white;
+				}
+			}
+			return signal;
+		}
+
+		/* signal, setup, runs signal through a Lane<Float> in chunks of BlockSize, returns the result in double */
+		template<typename Float>
+		Signal renderLane(const Signal& signal, const LaneSetup& setup)
+		{
+			const auto numSamples = static_cast<int>(signal[0].size());
+			std::array<std::vector<Float>, NumChannels> buffer;
+			for (auto ch = 0; ch < NumChannels; ++ch)
+				buffer[ch].assign(signal[ch].begin(), signal[ch].end());
+
+			auto lane = std::make_unique<Lane<Float>>();
+			lane->prepare(SampleRate, setup);
+			for (auto s = 0; s < numSamples; s += BlockSize)
+			{
+				Float* block[NumChannels];
+				for (auto ch = 0; ch < NumChannels; ++ch)
+					block[ch] = buffer[ch].data() + s;
+				lane->operator()(block, NumChannels, std::min(numSamples - s, BlockSize));
+			}
+
+			Signal result;
+			for (auto ch = 0; ch < NumChannels; ++ch)
+				result[ch].assign(buffer[ch].begin(), buffer[ch].end());
+			return result;
+		}
+
+		/* a, b, the largest difference between them in db full scale */
+		inline double getErrorDb(const Signal& a, const Signal& b)
+		{
+			auto error = 0.;
+			for (auto ch = 0; ch < NumChannels; ++ch)
+				for (size_t s = 0; s < a[ch].size(); ++s)
+					error = std::max(error, std::abs(a[ch][s] - b[ch][s]));
+			return error == 0. ? -300. : 20. * std::log10(error);
+		}
+
+		/* name, errorDb, toleranceDb, prints the check, returns true if it passed */
+		inline bool report(const std::string& name, double errorDb, double toleranceDb)
+		{
+			const auto passed = errorDb <= toleranceDb;
+			std::cout << name << ": max error " << errorDb << " dbfs, tolerance "
+				<< toleranceDb << " dbfs " << (passed ? "ok" : "FAILED") << "\n";
+			return passed;
+		}
+
+		/* filter, the float chain against the double chain on the same input.
+		float rounds at about -150 dbfs, the recursive filters accumulate some of it.
+		the crossover's low splits at 4x get closest, to about -100 dbfs */
+		inline bool verifyPrecision(const std::string& filter)
+		{
+			// an lsb of 16 bit
+			static constexpr double ToleranceDb = -96.;
+			const auto signal = makeSignal(static_cast<int>(SampleRate));
+			auto passed = true;
+			for (const auto order : { OversamplingOrder::x1, OversamplingOrder::x4 })
+				for (const auto filterOrder : { 1, 4 })
+					for (const auto numBands : { 1, 5 })
+					{
+						const auto name = "PrecisionLane" + std::to_string(1 << static_cast<int>(order)) + "x"
+							+ "Order" + std::to_string(filterOrder) + "Bands" + std::to_string(numBands);
+						if (!filter.empty() && name.find(filter) == std::string::npos)
+							continue;
+						const LaneSetup setup{ order, OversamplerMode::Polyphase, filterOrder, numBands };
+						const auto errorDb = getErrorDb(renderLane<float>(signal, setup), renderLane<double>(signal, setup));
+						passed = report(name, errorDb, ToleranceDb) && passed;
+					}
+			return passed;
+		}
+
+		/* ir, numSamples, runs noise through a Convolver with ir's kernel, which folds symmetric
+		taps and only keeps the tap of a delay. returns the largest difference to the plain
+		direct form sum over all taps of ir, in double, in db full scale */
+		template<typename Float>
+		double getKernelErrorDb(const ImpulseResponse<Float>& ir, int numSamples)
+		{
+			std::array<std::vector<Float>, NumChannels> buffer;
+			auto noise = 1u;
+			for (auto& channel : buffer)
+				for (auto s = 0; s < numSamples; ++s)
+				{
+					noise = noise * 1664525u + 1013904223u;
+					channel.push_back(static_cast<Float>(static_cast<double>(noise >> 8) / static_cast<double>(1 << 24) - .5));
+				}
+			const auto input = buffer;
+
+			auto kernel = std::make_unique<ConvolverKernel<Float>>();
+			kernel->prepare(ir);
+			Convolver<Float> convolver;
+			convolver.prepare(*kernel);
+			Float* samples[] = { buffer[0].data(), buffer[1].data() };
+			convolver.processBlock(samples, NumChannels, numSamples);
+
+			auto error = 0.;
+			for (auto ch = 0; ch < NumChannels; ++ch)
+				for (auto s = 0; s < numSamples; ++s)
+				{
+					auto y = 0.;
+					for (auto i = 0; i < ir.size && i <= s; ++i)
+						y += static_cast<double>(ir[i]) * static_cast<double>(input[ch][s - i]);
+					error = std::max(error, std::abs(y - static_cast<double>(buffer[ch][s])));
+				}
+			return error == 0. ? -300. : 20. * std::log10(error);
+		}
+
+		/* filter, the kernels of the oversampler's filters in each form
+		(symmetric of odd and even size, delay, generic) against the plain direct form.
+		only the order of the additions differs, so the error is rounding */
+		template<typename Float>
+		bool verifyKernels(const std::string& filter)
+		{
+			using IR = ImpulseResponse<Float>;
+			static constexpr bool IsFloat = sizeof(Float) == sizeof(float);
+			static constexpr double ToleranceDb = IsFloat ? -120. : -280.;
+			static constexpr double SampleRateUp = 88200.;
+			static constexpr int NumSamples = 1 << 12;
+			const std::string precision = IsFloat ? "float" : "double";
+
+			auto passed = true;
+			const auto check = [&](const std::string& name, const IR& ir)
+			{
+				if (!filter.empty() && name.find(filter) == std::string::npos)
+					return;
+				passed = report(name + " " + precision, getKernelErrorDb(ir, NumSamples), ToleranceDb) && passed;
+			};
+
+			static constexpr const char* QualityNames[] = { "Eco", "Balanced", "Mastering" };
+			for (auto q = 0; q < static_cast<int>(OversamplerQuality::NumQualities); ++q)
+			{
+				const auto targets = getOversamplerTargets(static_cast<OversamplerQuality>(q));
+				const auto stopband = SampleRateUp * .5 - targets.passband * .5;
+				auto lowpass = std::make_unique<IR>();
+				lowpass->makeLowpass(SampleRateUp, targets.passband, stopband,
+					targets.attenuationDb, targets.rippleDb, false);
+				auto halfband = std::make_unique<IR>();
+				halfband->makeHalfband(SampleRateUp, targets.passband,
+					targets.attenuationDb, targets.rippleDb, false);
+				auto minimumPhase = std::make_unique<IR>(*lowpass);
+				minimumPhase->makeMinimumPhase();
+
+				const auto name = std::string("Kernel") + QualityNames[q];
+				check(name + "Lowpass", *lowpass);
+				check(name + "Halfband", *halfband);
+				check(name + "MinimumPhase", *minimumPhase);
+				auto phase = std::make_unique<IR>();
+				for (auto p = 0; p < 2; ++p)
+				{
+					phase->makePhase(*lowpass, p, 2);
+					check(name + "LowpassPhase" + std::to_string(p), *phase);
+					phase->makePhase(*halfband, p, 2);
+					check(name + "HalfbandPhase" + std::to_string(p), *phase);
+				}
+			}
+			return passed;
+		}
+	}
+
+	bool verify(const std::string& filter)
+	{
+		auto passed = true;
+		passed = verification::verifyPrecision(filter) && passed;
+		passed = verification::verifyKernels<float>(filter) && passed;
+		passed = verification::verifyKernels<double>(filter) && passed;
+		return passed;
+	}
+}
\ No newline at end of file
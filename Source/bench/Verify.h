@@ -0,0 +1,48 @@
+#pragma once
+#include "../audio/dsp/SlewLimiter.h"
+#include "../audio/dsp/Crossover.h"
+#include "../audio/dsp/Oversampler.h"
+#include <memory>
+#include <string>
+
+namespace bench
+{
+	/* what a lane of the plugin runs: the oversampler around the slew limiter,
+	or around the crossover with a slew limiter per band */
+	struct LaneSetup
+	{
+		dsp::OversamplingOrder order;
+		dsp::OversamplerMode mode;
+		int filterOrder, numBands;
+	};
+
+	/* HQLane and PluginProcessor without params: fused if it can, block by block otherwise */
+	template<typename Float>
+	struct Lane
+	{
+		static constexpr int MaxBands = 5;
+		using Slew = dsp::SlewLimiterStereo<Float>;
+
+		Lane();
+
+		/* sampleRate, setup, allocates */
+		void prepare(double, const LaneSetup&);
+
+		/* samples, numChannels, numSamples, numSamples <= BlockSize */
+		void operator()(Float* const*, int, int) noexcept;
+
+	private:
+		dsp::Oversampler<Float> oversampler;
+		dsp::Crossover<Float, MaxBands> crossover;
+		std::array<Slew, MaxBands> slews;
+		std::array<Float, MaxBands> rates;
+		LaneSetup setup;
+
+		/* samples, numChannels, numSamples, at the oversampled rate */
+		void process(Float* const*, int, int) noexcept;
+	};
+
+	/* filter, runs the accuracy checks whose name contains filter.
+	each prints its largest error against its tolerance. returns false if any fails */
+	bool verify(const std::string&);
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "Render.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <iostream>
+
+namespace cli
+{
+	inline void printUsage()
+	{
+		std::cout <<
+			"renders audio files through Slew Over without a host\n"
+			"\n"
+			"usage: SlewOverCLI [options] input [input ...]\n"
+			"\n"
+			"  -o, --output <file|folder>  output file, or a folder for many inputs.\n"
+			"                              default: <input>_slewover next to the input\n"
+			"  -p, --patch <file.xml>      loads a patch saved by the plugin\n"
+			"  -s, --set <param>=<value>   sets a parameter by name, e.g. -s \"Slew=440\"\n"
+			"  -j, --jobs <n>              threads for many inputs, default: one per core\n"
+			"  -b, --block <n>             host buffer size, default: 512\n"
+			"      --bits <n>              bit depth of the output, default: the input's\n"
+			"      --double                processes in double precision\n"
+			"      --list                  lists the parameters and their defaults\n";
+	}
+
+	struct Job
+	{
+		File input, output;
+		RenderResult result;
+	};
+
+	/* input, output, numInputs */
+	inline File getOutputFile(const File& input, const File& output, int numInputs)
+	{
+		const auto name = input.getFileNameWithoutExtension() + "_slewover" + input.getFileExtension();
+		if (output == File())
+			return input.getSiblingFile(name);
+		if (numInputs > 1 || output.isDirectory())
+			return output.getChildFile(name);
+		return output;
+	}
+
+	inline int run(const juce::StringArray& args)
+	{
+		RenderOptions options;
+		juce::Array<File> inputs;
+		File output;
+		auto numThreads = 0;
+
+		for (auto i = 0; i < args.size(); ++i)
+		{
+			const auto& arg = args[i];
+			const auto hasValue = i + 1 < args.size();
+			if ((arg == "-h" || arg == "--help"))
+			{
+				printUsage();
+				return 0;
+			}
+			else if (arg == "--list")
+			{
+				audio::Processor processor;
+				std::cout << getParameterList(processor);
+				return 0;
+			}
+			else if (arg == "--double")
+				options.doublePrecision = true;
+			else if ((arg == "-o" || arg == "--output") && hasValue)
+				output = File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+			else if ((arg == "-p" || arg == "--patch") && hasValue)
+				options.patch = File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+			else if ((arg == "-s" || arg == "--set") && hasValue)
+			{
+				const auto value = args[++i];
+				if (!value.containsChar('='))
+				{
+					std::cerr << "expected <param>=<value>: " << value << "\n";
+					return 1;
+				}
+				options.values.push_back({ value.upToFirstOccurrenceOf("=", false, false).trim(),
+					value.fromFirstOccurrenceOf("=", false, false).trim() });
+			}
+			else if ((arg == "-j" || arg == "--jobs") && hasValue)
+				numThreads = args[++i].getIntValue();
+			else if ((arg == "-b" || arg == "--block") && hasValue)
+				options.blockSize = juce::jmax(1, args[++i].getIntValue());
+			else if (arg == "--bits" && hasValue)
+				options.bitsPerSample = args[++i].getIntValue();
+			else if (arg.startsWith("-"))
+			{
+				std::cerr << "unknown option: " << arg << "\n";
+				printUsage();
+				return 1;
+			}
+			else
+				inputs.add(File::getCurrentWorkingDirectory().getChildFile(arg));
+		}
+
+		if (inputs.isEmpty())
+		{
+			printUsage();
+			return 1;
+		}
+		if (inputs.size() > 1)
+			output.createDirectory();
+
+		std::vector<Job> jobs;
+		for (const auto& input : inputs)
+			jobs.push_back({ input, getOutputFile(input, output, inputs.size()), {} });
+
+		using Clock = std::chrono::steady_clock;
+		const auto start = Clock::now();
+		{
+			ThreadPool pool(inputs.size() > 1 ? numThreads : 1);
+			for (auto& job : jobs)
+				pool.push([&job, &options]
+				{
+					job.result = render(job.input, job.output, options);
+				});
+			pool.wait();
+		}
+		const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		auto numFailed = 0;
+		auto audioSeconds = 0.;
+		for (const auto& job : jobs)
+		{
+			const auto& result = job.result;
+			if (result.failed())
+			{
+				++numFailed;
+				std::cerr << job.input.getFileName() << ": " << result.error << "\n";
+				continue;
+			}
+			audioSeconds += result.audioSeconds;
+			std::cout << job.input.getFileName() << " -> " << job.output.getFullPathName() << ": "
+				<< String(result.audioSeconds, 2) << " s in " << String(result.renderSeconds, 2) << " s, "
+				<< String(result.getRealtimeFactor(), 1) << "x realtime\n";
+		}
+		if (jobs.size() > 1)
+			std::cout << "total: " << String(audioSeconds, 2) << " s of audio in " << String(seconds, 2) << " s, "
+				<< String(seconds > 0. ? audioSeconds / seconds : 0., 1) << "x realtime\n";
+
+		return numFailed == 0 ? 0 : 1;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	// the processor is a timer and its parameters notify listeners, both want a message manager
+	juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+	juce::StringArray args;
+	for (auto i = 1; i < argc; ++i)
+		args.add(juce::String::fromUTF8(argv[i]));
+	return cli::run(args);
+}
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "Render.h"
+#include <chrono>
+#include <mutex>
+
+namespace cli
+{
+	RenderOptions::RenderOptions() :
+		patch(),
+		values(),
+		blockSize(512),
+		bitsPerSample(0),
+		doublePrecision(false)
+	{
+	}
+
+	bool RenderResult::failed() const noexcept
+	{
+		return error.isNotEmpty();
+	}
+
+	double RenderResult::getRealtimeFactor() const noexcept
+	{
+		return renderSeconds > 0. ? audioSeconds / renderSeconds : 0.;
+	}
+
+	namespace renderer
+	{
+		using Reader = juce::AudioFormatReader;
+		using Writer = juce::AudioFormatWriter;
+
+		// a Processor reads and writes the user's settings file when it is made and destroyed
+		inline std::mutex& getLifetimeMutex()
+		{
+			static std::mutex mutex;
+			return mutex;
+		}
+
+		struct ProcessorDeleter
+		{
+			void operator()(audio::Processor* processor) const
+			{
+				std::lock_guard<std::mutex> lock(getLifetimeMutex());
+				delete processor;
+			}
+		};
+
+		using ProcessorPtr = std::unique_ptr<audio::Processor, ProcessorDeleter>;
+
+		inline ProcessorPtr makeProcessor()
+		{
+			std::lock_guard<std::mutex> lock(getLifetimeMutex());
+			return ProcessorPtr(new audio::Processor());
+		}
+
+		inline juce::AudioFormatManager& getFormatManager()
+		{
+			static juce::AudioFormatManager formatManager;
+			static std::once_flag registered;
+			std::call_once(registered, [] { formatManager.registerBasicFormats(); });
+			return formatManager;
+		}
+
+		/* input, memory mapped if the format supports it, streamed otherwise */
+		inline std::unique_ptr<Reader> makeReader(const File& input)
+		{
+			auto& formatManager = getFormatManager();
+			if (auto format = formatManager.findFormatForFileExtension(input.getFileExtension()))
+			{
+				std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(input));
+				if (mapped != nullptr && mapped->mapEntireFile())
+					return mapped;
+			}
+			return std::unique_ptr<Reader>(formatManager.createReaderFor(input));
+		}
+
+		/* output, reader, bitsPerSample */
+		inline std::unique_ptr<Writer> makeWriter(const File& output, const Reader& reader, int bitsPerSample)
+		{
+			auto format = getFormatManager().findFormatForFileExtension(output.getFileExtension());
+			if (format == nullptr)
+				return nullptr;
+			output.deleteFile();
+			std::unique_ptr<juce::OutputStream> stream(output.createOutputStream());
+			if (stream == nullptr)
+				return nullptr;
+			if (bitsPerSample == 0)
+				bitsPerSample = static_cast<int>(reader.bitsPerSample);
+			std::unique_ptr<Writer> writer(format->createWriterFor(stream.get(), reader.sampleRate,
+				reader.numChannels, bitsPerSample, {}, 0));
+			if (writer != nullptr)
+				stream.release();
+			return writer;
+		}
+
+		/* processor, options, returns an error or nothing */
+		inline String applyOptions(audio::Processor& processor, const RenderOptions& options)
+		{
+			if (options.patch != File())
+			{
+				if (!options.patch.existsAsFile())
+					return "patch not found: " + options.patch.getFullPathName();
+				processor.state.loadPatch(options.patch);
+				processor.params.loadPatch(processor.state);
+			}
+
+			for (const auto& value : options.values)
+			{
+				const auto idx = processor.params.getParamIdx(value.first);
+				if (idx < 0)
+					return "unknown parameter: " + value.first;
+				auto& param = processor.params(idx);
+				param.setValue(param.getValueForText(value.second));
+			}
+			return {};
+		}
+
+		/* processor, reader, writer, blockSize, returns the rendered number of samples */
+		template<typename Float>
+		juce::int64 process(audio::Processor& processor, Reader& reader, Writer& writer, int blockSize)
+		{
+			const auto numChannels = static_cast<int>(reader.numChannels);
+			const auto length = reader.lengthInSamples;
+			const auto latency = static_cast<juce::int64>(processor.getLatencySamples());
+
+			juce::AudioBuffer<float> bufferIO(numChannels, blockSize);
+			juce::AudioBuffer<Float> buffer(numChannels, blockSize);
+			juce::MidiBuffer midi;
+
+			// the input is followed by latency samples of silence, reads past the end come back as zeros.
+			// the first latency samples of the output are dropped
+			for (juce::int64 pos = 0; pos < length + latency; pos += blockSize)
+			{
+				const auto numSamples = static_cast<int>(std::min(static_cast<juce::int64>(blockSize), length + latency - pos));
+				reader.read(&bufferIO, 0, numSamples, pos, true, true);
+
+				if constexpr (std::is_same_v<Float, float>)
+				{
+					juce::AudioBuffer<float> block(bufferIO.getArrayOfWritePointers(), numChannels, numSamples);
+					processor.processBlock(block, midi);
+				}
+				else
+				{
+					{
+						PPDTraceScope("float to double");
+						for (auto ch = 0; ch < numChannels; ++ch)
+						{
+							const auto src = bufferIO.getReadPointer(ch);
+							auto dest = buffer.getWritePointer(ch);
+							for (auto s = 0; s < numSamples; ++s)
+								dest[s] = static_cast<Float>(src[s]);
+						}
+					}
+					juce::AudioBuffer<Float> block(buffer.getArrayOfWritePointers(), numChannels, numSamples);
+					processor.processBlock(block, midi);
+					PPDTraceScope("double to float");
+					for (auto ch = 0; ch < numChannels; ++ch)
+					{
+						const auto src = buffer.getReadPointer(ch);
+						auto dest = bufferIO.getWritePointer(ch);
+						for (auto s = 0; s < numSamples; ++s)
+							dest[s] = static_cast<float>(src[s]);
+					}
+				}
+				midi.clear();
+
+				const auto skip = static_cast<int>(std::clamp(latency - pos, static_cast<juce::int64>(0), static_cast<juce::int64>(numSamples)));
+				if (skip < numSamples)
+					writer.writeFromAudioSampleBuffer(bufferIO, skip, numSamples - skip);
+			}
+			return length;
+		}
+	}
+
+	RenderResult render(const File& input, const File& output, const RenderOptions& options)
+	{
+		using Clock = std::chrono::steady_clock;
+		const auto start = Clock::now();
+		RenderResult result{ {}, 0., 0. };
+
+		auto reader = renderer::makeReader(input);
+		if (reader == nullptr)
+		{
+			result.error = "can't read " + input.getFullPathName();
+			return result;
+		}
+		const auto numChannels = static_cast<int>(reader->numChannels);
+		if (numChannels < 1 || numChannels > dsp::MaxChannels)
+		{
+			result.error = "unsupported number of channels: " + String(numChannels);
+			return result;
+		}
+
+		auto processor = renderer::makeProcessor();
+		const auto layout = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+		const auto channelSet = layout.isDisabled() ? juce::AudioChannelSet::discreteChannels(numChannels) : layout;
+		juce::AudioProcessor::BusesLayout busesLayout;
+		busesLayout.inputBuses.add(channelSet);
+		busesLayout.outputBuses.add(channelSet);
+		if (!processor->setBusesLayout(busesLayout))
+		{
+			result.error = "unsupported channel layout: " + channelSet.getDescription();
+			return result;
+		}
+
+		result.error = renderer::applyOptions(*processor, options);
+		if (result.failed())
+			return result;
+
+		auto writer = renderer::makeWriter(output, *reader, options.bitsPerSample);
+		if (writer == nullptr)
+		{
+			result.error = "can't write " + output.getFullPathName();
+			return result;
+		}
+
+		processor->setProcessingPrecision(options.doublePrecision ?
+			juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+		processor->setRateAndBufferSizeDetails(reader->sampleRate, options.blockSize);
+		processor->prepareToPlay(reader->sampleRate, options.blockSize);
+
+		const auto length = options.doublePrecision ?
+			renderer::process<double>(*processor, *reader, *writer, options.blockSize) :
+			renderer::process<float>(*processor, *reader, *writer, options.blockSize);
+		processor->releaseResources();
+		writer.reset();
+
+		result.audioSeconds = static_cast<double>(length) / reader->sampleRate;
+		result.renderSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+		return result;
+	}
+
+	String getParameterList(const audio::Processor& processor)
+	{
+		String list;
+		const auto& params = processor.params;
+		for (const auto param : params.data())
+		{
+			list += param->getName(64) + ": " + param->getText(param->getValue(), 64);
+			list += juce::newLine;
+		}
+		return list;
+	}
+}
\ No newline at end of file
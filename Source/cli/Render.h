@@ -0,0 +1,40 @@
+#pragma once
+#include "../Processor.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+
+namespace cli
+{
+	using String = juce::String;
+	using File = juce::File;
+
+	struct RenderOptions
+	{
+		RenderOptions();
+
+		File patch;
+		// name or id of a parameter and its value as text, like in the plugin's value fields
+		std::vector<std::pair<String, String>> values;
+		int blockSize, bitsPerSample;
+		bool doublePrecision;
+	};
+
+	struct RenderResult
+	{
+		String error;
+		double audioSeconds, renderSeconds;
+
+		bool failed() const noexcept;
+
+		/* audio duration over render time */
+		double getRealtimeFactor() const noexcept;
+	};
+
+	/* input, output, options
+	streams a wav or aiff file through the plugin's Processor, chunk by chunk.
+	memory maps the input where the format allows. the output is compensated for the
+	oversampler's latency and has the same length as the input. any thread */
+	RenderResult render(const File&, const File&, const RenderOptions&);
+
+	/* processor, lists the parameters with their current values */
+	String getParameterList(const audio::Processor&);
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "ThreadPool.h"
+
+namespace cli
+{
+	ThreadPool::ThreadPool(int numThreads) :
+		workers(),
+		mutex(),
+		taskAdded(),
+		tasksDone(),
+		numQueued(0),
+		numPending(0),
+		running(true),
+		nextWorker(0)
+	{
+		if (numThreads <= 0)
+			numThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+		for (auto i = 0; i < numThreads; ++i)
+			workers.push_back(std::make_unique<Worker>());
+		for (auto i = 0; i < numThreads; ++i)
+			workers[i]->thread = std::thread([this, i] { run(i); });
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			running.store(false);
+		}
+		taskAdded.notify_all();
+		for (auto& worker : workers)
+			worker->thread.join();
+	}
+
+	void ThreadPool::push(Task task)
+	{
+		auto& worker = *workers[nextWorker];
+		nextWorker = (nextWorker + 1) % static_cast<int>(workers.size());
+		numPending.fetch_add(1);
+		{
+			std::lock_guard<std::mutex> lock(worker.mutex);
+			worker.tasks.push_back(std::move(task));
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			numQueued.fetch_add(1);
+		}
+		taskAdded.notify_all();
+	}
+
+	void ThreadPool::wait()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		tasksDone.wait(lock, [this] { return numPending.load() == 0; });
+	}
+
+	int ThreadPool::getNumThreads() const noexcept
+	{
+		return static_cast<int>(workers.size());
+	}
+
+	void ThreadPool::run(int idx)
+	{
+		while (true)
+		{
+			Task task;
+			if (take(idx, task))
+			{
+				task();
+				if (numPending.fetch_sub(1) == 1)
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					tasksDone.notify_all();
+				}
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(mutex);
+			taskAdded.wait(lock, [this] { return numQueued.load() > 0 || !running.load(); });
+			if (!running.load() && numQueued.load() == 0)
+				return;
+		}
+	}
+
+	bool ThreadPool::take(int idx, Task& task)
+	{
+		const auto numWorkers = static_cast<int>(workers.size());
+		for (auto i = 0; i < numWorkers; ++i)
+		{
+			auto& worker = *workers[(idx + i) % numWorkers];
+			std::lock_guard<std::mutex> lock(worker.mutex);
+			if (worker.tasks.empty())
+				continue;
+			if (i == 0)
+			{
+				task = std::move(worker.tasks.back());
+				worker.tasks.pop_back();
+			}
+			else
+			{
+				task = std::move(worker.tasks.front());
+				worker.tasks.pop_front();
+			}
+			numQueued.fetch_sub(1);
+			return true;
+		}
+		return false;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cli
+{
+	/* a pool of workers with a deque each. tasks are dealt out round robin,
+	a worker takes from the back of its own deque and, once that is empty,
+	steals from the front of the others'. long and short jobs even out that way */
+	struct ThreadPool
+	{
+		using Task = std::function<void()>;
+
+		/* numThreads, 0 for one per core */
+		ThreadPool(int);
+
+		~ThreadPool();
+
+		/* task */
+		void push(Task);
+
+		/* blocks until every pushed task is done */
+		void wait();
+
+		int getNumThreads() const noexcept;
+
+	private:
+		struct Worker
+		{
+			std::deque<Task> tasks;
+			std::mutex mutex;
+			std::thread thread;
+		};
+
+		std::vector<std::unique_ptr<Worker>> workers;
+		std::mutex mutex;
+		std::condition_variable taskAdded, tasksDone;
+		std::atomic<int> numQueued, numPending;
+		std::atomic<bool> running;
+		int nextWorker;
+
+		/* idx */
+		void run(int);
+
+		/* idx, task, own deque first, then the others' */
+		bool take(int, Task&);
+	};
+}
\ No newline at end of file
@@ -28,8 +28,25 @@ namespace param
 		{
 		case PID::GainOut: return "Gain Out";
 		case PID::HQ: return "HQ";
+		case PID::HQMode: return "HQ Mode";
+		case PID::HQQuality: return "HQ Quality";
 		case PID::Slew: return "Slew";
+		case PID::SlewFall: return "Slew Fall";
+		case PID::SlewLink: return "Slew Link";
+		case PID::SlewOrder: return "Slew Order";
 		case PID::FilterType: return "Filter Type";
+		case PID::Bands: return "Bands";
+		case PID::Crossover1: return "Crossover 1";
+		case PID::Crossover2: return "Crossover 2";
+		case PID::Crossover3: return "Crossover 3";
+		case PID::Crossover4: return "Crossover 4";
+		case PID::BandSlew1: return "Band 1 Slew";
+		case PID::BandSlew2: return "Band 2 Slew";
+		case PID::BandSlew3: return "Band 3 Slew";
+		case PID::BandSlew4: return "Band 4 Slew";
+		case PID::BandSlew5: return "Band 5 Slew";
+		case PID::HQFactor: return "HQ Factor";
+		case PID::BandPass: return "Band Pass";
 		default: return "Invalid Parameter Name";
 		}
 	}
@@ -63,8 +80,25 @@ namespace param
 		{
 		case PID::GainOut: return "Apply gain to the output signal.";
 		case PID::HQ: return "Apply oversampling to the signal.";
-		case PID::FilterType: return "Choose the filter type. (LP or HP)";
-		case PID::Slew: return "Apply the slew rate to the signal.";
+		case PID::HQMode: return "Choose the oversampling filters. (Linear: linear phase, IIR: lowest latency, Min Phase: steep and low latency, Half-band: linear phase and cheap)";
+		case PID::HQQuality: return "Choose the oversampling quality. (Eco, Balanced or Mastering)";
+		case PID::FilterType: return "Choose the filter type. (LP or HP) Changes crossfade.";
+		case PID::Slew: return "Apply the slew rate to the signal's rise, and to its fall while linked.";
+		case PID::SlewFall: return "Apply the slew rate to the signal's fall, while not linked.";
+		case PID::SlewLink: return "Link the fall to the rise rate.";
+		case PID::SlewOrder: return "Choose how many slew limiters run in series. Higher orders round off the edges.";
+		case PID::Bands: return "Choose how many frequency bands are slew limited separately.";
+		case PID::Crossover1: return "Split the lowest band from the ones above it here.";
+		case PID::Crossover2: return "Split the 2nd band from the ones above it here.";
+		case PID::Crossover3: return "Split the 3rd band from the ones above it here.";
+		case PID::Crossover4: return "Split the 4th band from the one above it here.";
+		case PID::BandSlew1: return "Offset the slew rate of the lowest band.";
+		case PID::BandSlew2: return "Offset the slew rate of the 2nd band.";
+		case PID::BandSlew3: return "Offset the slew rate of the 3rd band.";
+		case PID::BandSlew4: return "Offset the slew rate of the 4th band.";
+		case PID::BandSlew5: return "Offset the slew rate of the highest band.";
+		case PID::HQFactor: return "Choose the oversampling factor, while HQ is enabled. (Auto, 2x, 4x, 8x or 16x) Auto picks the highest one the HQ Quality allows at the host's sample rate.";
+		case PID::BandPass: return "Band-pass the signal instead of the filter type's LP or HP. Changes crossfade.";
 		default: return "Invalid Tooltip.";
 		}
 	}
@@ -98,6 +132,11 @@ namespace param
 		case Unit::Legato: return "";
 		case Unit::Custom: return "";
 		case Unit::FilterType: return "";
+		case Unit::Oversampling: return "x";
+		case Unit::OversamplingMode: return "";
+		case Unit::OversamplingQuality: return "";
+		case Unit::Stages: return "stages";
+		case Unit::Bands: return "bands";
 		default: return "";
 		}
 	}
@@ -771,6 +810,72 @@ namespace param::strToVal
 				return p(text, 0.f);
 		};
 	}
+
+	StrToValFunc oversampling()
+	{
+		return[p = parse()](const String& txt)
+		{
+			const auto text = txt.toLowerCase().trimCharactersAtEnd(toString(Unit::Oversampling));
+			if (text == "auto")
+				return 0.f;
+			const auto factor = p(text, 2.f);
+			if (factor < 2.f)
+				return 1.f;
+			return std::round(std::log2(factor));
+		};
+	}
+
+	StrToValFunc oversamplingMode()
+	{
+		return[p = parse()](const String& txt)
+		{
+			const auto text = txt.toLowerCase();
+			if (text == "linear" || text == "lin" || text == "fir")
+				return 0.f;
+			else if (text == "iir")
+				return 1.f;
+			else if (text == "min phase" || text == "minphase" || text == "min")
+				return 2.f;
+			else if (text == "half-band" || text == "halfband" || text == "hb")
+				return 3.f;
+			else
+				return p(text, 0.f);
+		};
+	}
+
+	StrToValFunc oversamplingQuality()
+	{
+		return[p = parse()](const String& txt)
+		{
+			const auto text = txt.toLowerCase();
+			if (text == "eco")
+				return 0.f;
+			else if (text == "balanced" || text == "bal")
+				return 1.f;
+			else if (text == "mastering" || text == "master")
+				return 2.f;
+			else
+				return p(text, 1.f);
+		};
+	}
+
+	StrToValFunc stages()
+	{
+		return[p = parse()](const String& txt)
+		{
+			const auto text = txt.toLowerCase().trimCharactersAtEnd(toString(Unit::Stages)).trim();
+			return std::round(p(text, 1.f));
+		};
+	}
+
+	StrToValFunc bands()
+	{
+		return[p = parse()](const String& txt)
+		{
+			const auto text = txt.toLowerCase().trimCharactersAtEnd(toString(Unit::Bands)).trim();
+			return std::round(p(text, 1.f));
+		};
+	}
 }
 
 namespace param::valToStr
@@ -1034,6 +1139,66 @@ namespace param::valToStr
 			}
 		};
 	}
+
+	ValToStrFunc oversampling()
+	{
+		return [](float v)
+		{
+			const auto order = static_cast<int>(std::round(v));
+			if (order == 0)
+				return String("Auto");
+			return String(1 << order) + toString(Unit::Oversampling);
+		};
+	}
+
+	ValToStrFunc oversamplingMode()
+	{
+		return [](float v)
+		{
+			const auto mode = static_cast<int>(std::round(v));
+			switch (mode)
+			{
+			case 0: return String("Linear");
+			case 1: return String("IIR");
+			case 2: return String("Min Phase");
+			case 3: return String("Half-band");
+			default: return String("");
+			}
+		};
+	}
+
+	ValToStrFunc oversamplingQuality()
+	{
+		return [](float v)
+		{
+			const auto quality = static_cast<int>(std::round(v));
+			switch (quality)
+			{
+			case 0: return String("Eco");
+			case 1: return String("Balanced");
+			case 2: return String("Mastering");
+			default: return String("");
+			}
+		};
+	}
+
+	ValToStrFunc stages()
+	{
+		return [](float v)
+		{
+			const auto order = static_cast<int>(std::round(v));
+			return String(order) + " " + (order == 1 ? String("stage") : toString(Unit::Stages));
+		};
+	}
+
+	ValToStrFunc bands()
+	{
+		return [](float v)
+		{
+			const auto numBands = static_cast<int>(std::round(v));
+			return String(numBands) + " " + (numBands == 1 ? String("band") : toString(Unit::Bands));
+		};
+	}
 }
 
 namespace param
@@ -1131,6 +1296,26 @@ namespace param
 			valToStrFunc = valToStr::filterType();
 			strToValFunc = strToVal::filterType();
 			break;
+		case Unit::Oversampling:
+			valToStrFunc = valToStr::oversampling();
+			strToValFunc = strToVal::oversampling();
+			break;
+		case Unit::OversamplingMode:
+			valToStrFunc = valToStr::oversamplingMode();
+			strToValFunc = strToVal::oversamplingMode();
+			break;
+		case Unit::OversamplingQuality:
+			valToStrFunc = valToStr::oversamplingQuality();
+			strToValFunc = strToVal::oversamplingQuality();
+			break;
+		case Unit::Stages:
+			valToStrFunc = valToStr::stages();
+			strToValFunc = strToVal::stages();
+			break;
+		case Unit::Bands:
+			valToStrFunc = valToStr::bands();
+			strToValFunc = strToVal::bands();
+			break;
 		case Unit::Pitch:
 			valToStrFunc = valToStr::pitch();
 			strToValFunc = strToVal::pitch();
@@ -1187,6 +1372,23 @@ namespace param
 		const auto gainOutRange = makeRange::withCentre(PPDGainOutMin, PPDGainOutMax, 0.f);
 		params.push_back(makeParam(PID::GainOut, 0.f, gainOutRange, Unit::Decibel));
 		params.push_back(makeParam(PID::HQ, 0.f, makeRange::toggle(), Unit::Power));
+		params.push_back(makeParam(PID::HQMode, 0.f, makeRange::stepped(0.f, 3.f), Unit::OversamplingMode));
+		params.push_back(makeParam(PID::HQQuality, 1.f, makeRange::stepped(0.f, 2.f), Unit::OversamplingQuality));
+		params.push_back(makeParam(PID::SlewFall, 36.f, makeRange::lin(0.f, 127.f), Unit::Pitch));
+		params.push_back(makeParam(PID::SlewLink, 1.f, makeRange::toggle(), Unit::Power));
+		params.push_back(makeParam(PID::SlewOrder, 1.f, makeRange::stepped(1.f, 8.f), Unit::Stages));
+		params.push_back(makeParam(PID::Bands, 1.f, makeRange::stepped(1.f, 5.f), Unit::Bands));
+		const auto crossoverRange = makeRange::foleysLogRange(20.f, 20000.f);
+		params.push_back(makeParam(PID::Crossover1, 120.f, crossoverRange, Unit::Hz));
+		params.push_back(makeParam(PID::Crossover2, 800.f, crossoverRange, Unit::Hz));
+		params.push_back(makeParam(PID::Crossover3, 3000.f, crossoverRange, Unit::Hz));
+		params.push_back(makeParam(PID::Crossover4, 9000.f, crossoverRange, Unit::Hz));
+		for (auto i = 0; i < 5; ++i)
+			params.push_back(makeParam(offset(PID::BandSlew1, i), 0.f, makeRange::lin(-48.f, 48.f), Unit::Semi));
+		// the order while HQ is enabled, 2x like the toggle HQ used to be, or 0 for auto
+		params.push_back(makeParam(PID::HQFactor, 1.f, makeRange::stepped(0.f, 4.f), Unit::Oversampling));
+		// overrides the filter type, which keeps its LP and HP values
+		params.push_back(makeParam(PID::BandPass, 0.f, makeRange::toggle(), Unit::Power));
 		
 		for (auto param : params)
 			audioProcessor.addParameter(param);
@@ -16,6 +16,23 @@ namespace param
 		FilterType,
 		GainOut,
 		HQ,
+		HQMode,
+		HQQuality,
+		SlewFall,
+		SlewLink,
+		SlewOrder,
+		Bands,
+		Crossover1,
+		Crossover2,
+		Crossover3,
+		Crossover4,
+		BandSlew1,
+		BandSlew2,
+		BandSlew3,
+		BandSlew4,
+		BandSlew5,
+		HQFactor,
+		BandPass,
 		NumParams
 	};
 	static constexpr int NumParams = static_cast<int>(PID::NumParams);
@@ -62,6 +79,11 @@ namespace param
 		Legato,
 		Custom,
 		FilterType,
+		Oversampling,
+		OversamplingMode,
+		OversamplingQuality,
+		Stages,
+		Bands,
 		NumUnits
 	};
 
@@ -246,6 +268,11 @@ namespace param
 		StrToValFunc beats();
 		StrToValFunc legato();
 		StrToValFunc filterType();
+		StrToValFunc oversampling();
+		StrToValFunc oversamplingMode();
+		StrToValFunc oversamplingQuality();
+		StrToValFunc stages();
+		StrToValFunc bands();
 	}
 
 	namespace valToStr
@@ -276,6 +303,11 @@ namespace param
 		ValToStrFunc beats();
 		ValToStrFunc legato();
 		ValToStrFunc filterType();
+		ValToStrFunc oversampling();
+		ValToStrFunc oversamplingMode();
+		ValToStrFunc oversamplingQuality();
+		ValToStrFunc stages();
+		ValToStrFunc bands();
 	}
 
 	void processMacroMod(Params&) noexcept;
@@ -25,9 +25,6 @@ GUI
 AUDIO
     FFT
         replace by 3rd party lib for performance (kiss fft or pffft)
-    Oversampler
-        make convolver FFT-based
-        implement 4x
     sidechain
         envfol on macro
     MixProcessor